@@ -2,10 +2,17 @@
 
 #include <toml++/toml.h>
 
+#include <algorithm>
+#include <array>
+#include <bitset>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace AutoTOML {
@@ -27,7 +34,7 @@ namespace AutoTOML {
             settings.push_back(this);
         }
 
-        virtual ~ISetting() = 0 {}
+        virtual ~ISetting() = 0;
 
         ISetting& operator=(const ISetting&) = delete;
         ISetting& operator=(ISetting&&) = delete;
@@ -51,6 +58,8 @@ namespace AutoTOML {
         string_t _key;
     };
 
+    inline ISetting::~ISetting() = default;
+
     namespace detail {
         template <class T, toml::node_type E>
         class tSetting : public ISetting {
@@ -128,4 +137,216 @@ namespace AutoTOML {
     using fSetting = detail::tSetting<float_t, toml::node_type::floating_point>;
     using iSetting = detail::tSetting<integer_t, toml::node_type::integer>;
     using sSetting = detail::tSetting<string_t, toml::node_type::string>;
+
+    // Allocation free alternative to ISetting: settings are constinit globals, and a constexpr schema lists them so
+    // a whole file is resolved in one walk over the parsed table. Only value types that need no allocation are
+    // supported.
+    namespace schema {
+        namespace detail {
+            template <class T>
+            struct node_type_of;
+
+            template <>
+            struct node_type_of<boolean_t> : std::integral_constant<toml::node_type, toml::node_type::boolean> {};
+
+            template <>
+            struct node_type_of<float_t> : std::integral_constant<toml::node_type, toml::node_type::floating_point> {};
+
+            template <>
+            struct node_type_of<integer_t> : std::integral_constant<toml::node_type, toml::node_type::integer> {};
+        }  // namespace detail
+
+        template <class T>
+        class tSetting {
+        public:
+            using value_type = T;
+            using reference = value_type&;
+            using const_reference = const value_type&;
+
+            static constexpr toml::node_type node_type = detail::node_type_of<T>::value;
+
+            tSetting() = delete;
+            tSetting(const tSetting&) = delete;
+            tSetting(tSetting&&) = delete;
+
+            constexpr explicit tSetting(value_type a_value) noexcept : _value(a_value) {}
+
+            tSetting& operator=(const tSetting&) = delete;
+            tSetting& operator=(tSetting&&) = delete;
+
+            [[nodiscard]] constexpr reference operator*() noexcept { return _value; }
+            [[nodiscard]] constexpr const_reference operator*() const noexcept { return _value; }
+
+            [[nodiscard]] constexpr reference get() noexcept { return _value; }
+            [[nodiscard]] constexpr const_reference get() const noexcept { return _value; }
+
+        private:
+            friend class Field;
+
+            value_type _value;
+        };
+
+        using bSetting = tSetting<boolean_t>;
+        using fSetting = tSetting<float_t>;
+        using iSetting = tSetting<integer_t>;
+
+        // Where a setting lives in the file and in memory. Fields are constexpr, only the setting's address is taken,
+        // so they can be sorted into a schema at compile time.
+        class Field {
+        public:
+            template <class T>
+            constexpr Field(std::string_view a_group, std::string_view a_key, tSetting<T>& a_setting) noexcept
+                : _group(a_group),
+                  _key(a_key),
+                  _type(tSetting<T>::node_type),
+                  _value(std::addressof(a_setting._value)) {}
+
+            [[nodiscard]] constexpr std::string_view group() const noexcept { return _group; }
+            [[nodiscard]] constexpr std::string_view key() const noexcept { return _key; }
+            [[nodiscard]] constexpr toml::node_type type() const noexcept { return _type; }
+
+            [[nodiscard]] bool accepts(const toml::node& a_node) const noexcept { return a_node.type() == _type; }
+
+            // a_node must be accepted.
+            void assign(const toml::node& a_node) const {
+                switch (_type) {
+                    case toml::node_type::boolean:
+                        assign<boolean_t>(a_node);
+                        break;
+                    case toml::node_type::floating_point:
+                        assign<float_t>(a_node);
+                        break;
+                    case toml::node_type::integer:
+                        assign<integer_t>(a_node);
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            [[nodiscard]] friend constexpr bool operator<(const Field& a_lhs, const Field& a_rhs) noexcept {
+                return a_lhs._group != a_rhs._group ? a_lhs._group < a_rhs._group : a_lhs._key < a_rhs._key;
+            }
+
+        private:
+            template <class T>
+            void assign(const toml::node& a_node) const {
+                *static_cast<T*>(_value) = a_node.as<T>()->get();
+            }
+
+            std::string_view _group;
+            std::string_view _key;
+            toml::node_type _type;
+            void* _value;
+        };
+
+        template <std::size_t N>
+        using Schema = std::array<Field, N>;
+
+        // Builds a schema sorted by group and key.
+        template <class... Ts>
+        [[nodiscard]] consteval auto make_schema(const Ts&... a_fields) noexcept {
+            Schema<sizeof...(Ts)> schema{a_fields...};
+            std::sort(schema.begin(), schema.end());
+            return schema;
+        }
+
+        // Same for a list of fields already in an array, such as one generated by a macro.
+        template <std::size_t N>
+        [[nodiscard]] consteval auto make_schema(Schema<N> a_fields) noexcept {
+            std::sort(a_fields.begin(), a_fields.end());
+            return a_fields;
+        }
+
+        // Problems found by load, one per line.
+        struct Report {
+            string_t errors;    // values of the wrong type, the file has to be fixed
+            string_t warnings;  // missing values, older files simply lack the newer settings
+
+            [[nodiscard]] bool ok() const noexcept { return errors.empty(); }
+        };
+
+        // The values of a table matched to a schema but not assigned yet, so a file with errors can be rejected as a
+        // whole. Points into the table, which has to outlive it.
+        template <std::size_t N>
+        struct Staged {
+            Report report;
+            std::array<const toml::node*, N> nodes{};  // by schema index, nullptr if missing
+        };
+
+        // Matches a_table against a_schema in a single pass over the table and checks every value's type.
+        template <std::size_t N>
+        [[nodiscard]] Staged<N> stage(const toml::table& a_table, const Schema<N>& a_schema) {
+            Staged<N> staged;
+            std::bitset<N> found;
+
+            const auto add = [](string_t& a_lines, const Field& a_field, std::string_view a_problem) {
+                if (!a_lines.empty()) {
+                    a_lines += '\n';
+                }
+                a_lines += '[';
+                a_lines += a_field.group();
+                a_lines += "] "sv;
+                a_lines += a_field.key();
+                a_lines += ": value is not "sv;
+                a_lines += a_problem;
+            };
+
+            for (const auto& [groupKey, groupNode] : a_table) {
+                const auto group = groupNode.as_table();
+                if (!group) {
+                    continue;
+                }
+
+                const std::string_view groupName = groupKey.str();
+                for (const auto& [key, node] : *group) {
+                    const std::string_view keyName = key.str();
+                    const auto it = std::ranges::lower_bound(a_schema, std::pair{groupName, keyName}, std::less{},
+                                                             [](const Field& a_field) {
+                                                                 return std::pair{a_field.group(), a_field.key()};
+                                                             });
+                    if (it == a_schema.end() || it->group() != groupName || it->key() != keyName) {
+                        continue;
+                    }
+
+                    const auto index = static_cast<std::size_t>(std::distance(a_schema.begin(), it));
+                    found.set(index);
+                    if (it->accepts(node)) {
+                        staged.nodes[index] = &node;
+                    } else {
+                        add(staged.report.errors, *it, "of expected type"sv);
+                    }
+                }
+            }
+
+            for (std::size_t i = 0; i < N; ++i) {
+                if (!found[i]) {
+                    add(staged.report.warnings, a_schema[i], "found, left unchanged"sv);
+                }
+            }
+
+            return staged;
+        }
+
+        // Assigns the staged values. Settings that are missing keep their current value, which is the constinit
+        // default until something was loaded. a_staged must have no errors.
+        template <std::size_t N>
+        void assign(const Staged<N>& a_staged, const Schema<N>& a_schema) {
+            for (std::size_t i = 0; i < N; ++i) {
+                if (a_staged.nodes[i]) {
+                    a_schema[i].assign(*a_staged.nodes[i]);
+                }
+            }
+        }
+
+        // Stages a_table and applies it if there are no errors. Either every value in the file is loaded or none is.
+        template <std::size_t N>
+        [[nodiscard]] Report load(const toml::table& a_table, const Schema<N>& a_schema) {
+            auto staged = stage(a_table, a_schema);
+            if (staged.report.ok()) {
+                assign(staged, a_schema);
+            }
+            return std::move(staged.report);
+        }
+    }  // namespace schema
 }  // namespace AutoTOML
@@ -0,0 +1,39 @@
+#include "FileWatcher.h"
+
+namespace FileWatcher {
+    namespace {
+        [[nodiscard]] std::filesystem::file_time_type GetWriteTime(const std::filesystem::path& a_path) {
+            std::error_code ec;
+            const auto time = std::filesystem::last_write_time(a_path, ec);
+            return ec ? std::filesystem::file_time_type{} : time;
+        }
+    }  // namespace
+
+    void Watch(std::filesystem::path a_path, std::function<void()> a_onChange) {
+        const auto dir = std::filesystem::absolute(a_path).parent_path();
+        const auto handle = FindFirstChangeNotificationW(dir.c_str(), FALSE, FILE_NOTIFY_CHANGE_LAST_WRITE);
+        if (handle == INVALID_HANDLE_VALUE) {
+            logger::error("Failed to watch {}"sv, dir.string());
+            return;
+        }
+
+        std::thread([handle, path = std::move(a_path), onChange = std::move(a_onChange)]() {
+            auto lastWrite = GetWriteTime(path);
+            while (WaitForSingleObject(handle, INFINITE) == WAIT_OBJECT_0) {
+                // editors tend to write in several steps, give them a moment to finish
+                std::this_thread::sleep_for(100ms);
+
+                const auto writeTime = GetWriteTime(path);
+                if (writeTime != lastWrite) {
+                    lastWrite = writeTime;
+                    onChange();
+                }
+
+                if (!FindNextChangeNotification(handle)) {
+                    break;
+                }
+            }
+            FindCloseChangeNotification(handle);
+        }).detach();
+    }
+}  // namespace FileWatcher
@@ -0,0 +1,6 @@
+#pragma once
+
+namespace FileWatcher {
+    // Calls a_onChange from a background thread every time a_path is written to.
+    void Watch(std::filesystem::path a_path, std::function<void()> a_onChange);
+}
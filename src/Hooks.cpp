@@ -1,262 +1,611 @@
 #include "Hooks.h"
 
+#include "Menus.h"
+#include "Notifications.h"
+#include "PatchTransaction.h"
+#include "Patches.h"
+#include "Profiler.h"
 #include "Settings.h"
+#include "Signature.h"
+#include "Stats.h"
 
 namespace Hooks {
     namespace {
-        template <class T, std::uint64_t FUNC_ID>
-        void SkipSubMenuMenuPrompt() {
-            REL::Relocation<void(T*)> func{REL::ID(FUNC_ID)};
-            const auto ui = RE::UI::GetSingleton();
-            const auto craftingMenu = ui->GetMenu<RE::CraftingMenu>();
-            const auto subMenu = static_cast<T*>(craftingMenu->GetCraftingSubMenu());
-            func(subMenu);
+        template <class T>
+        [[nodiscard]] bool IsBatchEnabled() {
+            if constexpr (std::is_same_v<T, RE::CraftingSubMenus::ConstructibleObjectMenu>) {
+                return *Settings::BatchConstructibleObjectMenu;
+            } else if constexpr (std::is_same_v<T, RE::CraftingSubMenus::AlchemyMenu>) {
+                return *Settings::BatchAlchemyMenu;
+            } else if constexpr (std::is_same_v<T, RE::CraftingSubMenus::SmithingMenu>) {
+                return *Settings::BatchSmithingMenu;
+            } else {
+                return false;
+            }
         }
 
-        struct SubMenuPatchCode : public Xbyak::CodeGenerator {
-        public:
-            SubMenuPatchCode(std::size_t a_callAddr, std::size_t a_retAddr) {
-                Xbyak::Label callLbl;
-                Xbyak::Label retLbl;
+        // How many more times the materials consumed between the two snapshots can be afforded.
+        [[nodiscard]] std::int64_t GetBatchBudget(const RE::TESObjectREFR::InventoryCountMap& a_before,
+                                                  const RE::TESObjectREFR::InventoryCountMap& a_after) {
+            std::int64_t budget = std::numeric_limits<std::int64_t>::max();
+            bool consumed = false;
+            for (const auto& [obj, count] : a_before) {
+                const auto it = a_after.find(obj);
+                const std::int64_t remaining = it != a_after.end() ? it->second : 0;
+                if (remaining < count) {
+                    consumed = true;
+                    budget = std::min(budget, remaining / (count - remaining));
+                }
+            }
+            return consumed ? budget : 0;
+        }
 
-                call(ptr[rip + callLbl]);
-                jmp(ptr[rip + retLbl]);
+        // engine functions needed by the callbacks, resolved once by Install
+        std::array<std::uintptr_t, std::to_underlying(Patches::Callback::kTotal)> callbackFuncs{};
 
-                L(callLbl);
-                dq(a_callAddr);
+        [[nodiscard]] RE::EnchantmentItem* GetBaseEnchantment(const RE::InventoryEntryData* a_entry) {
+            const auto object = a_entry ? a_entry->object : nullptr;
+            const auto enchantable = object ? object->As<RE::TESEnchantableForm>() : nullptr;
+            const auto enchantment = enchantable ? enchantable->formEnchanting : nullptr;
+            if (!enchantment) {
+                return nullptr;
+            }
+            return enchantment->data.baseEnchantment ? enchantment->data.baseEnchantment : enchantment;
+        }
+
+        using EnchantConstructMenu = RE::CraftingSubMenus::EnchantConstructMenu;
+
+        [[nodiscard]] bool IsDisenchantEntry(const EnchantConstructMenu::CategoryListEntry& a_entry) {
+            using FilterFlag = EnchantConstructMenu::FilterFlag;
+            return a_entry.filterFlag.any(FilterFlag::DisenchantWeapon, FilterFlag::DisenchantArmor);
+        }
+
+        // Batches only take items the player marked for them by favoriting, everything else is left alone.
+        [[nodiscard]] bool IsMarked(RE::InventoryEntryData* a_entry) { return a_entry->IsFavorited(); }
+
+        // Marked items the player is not wearing and no quest needs, the only ones a batch may destroy.
+        [[nodiscard]] bool IsDisposable(RE::InventoryEntryData* a_entry) {
+            return IsMarked(a_entry) && !a_entry->IsWorn() && !a_entry->IsQuestObject();
+        }
 
-                L(retLbl);
-                dq(a_retAddr);
+        // Marked or worn items, the ones a batch may improve.
+        [[nodiscard]] bool IsSelected(RE::InventoryEntryData* a_entry) {
+            return IsMarked(a_entry) || a_entry->IsWorn();
+        }
+
+        using SmithingMenu = RE::CraftingSubMenus::SmithingMenu;
+
+        // The recipe's conditions, such as the perk an improvement needs, and the entry's own flag, which the engine
+        // clears once the player's skill caps the item. Checked before improving instead of trying and comparing.
+        [[nodiscard]] bool IsImprovable(const SmithingMenu::SmithingItemEntry& a_entry) {
+            const auto player = RE::PlayerCharacter::GetSingleton();
+            return a_entry.item && a_entry.constructibleObject && a_entry.available &&
+                   a_entry.constructibleObject->conditions.IsTrue(player, player);
+        }
+
+        // the engine's tempering tiers, Fine through Legendary
+        constexpr std::int64_t MAX_TEMPER_TIERS = 6;
+
+        // Takes what a_recipe needs out of a_inventory. Leaves it untouched and returns false if anything is short.
+        // The recipe's conditions are checked by IsImprovable.
+        [[nodiscard]] bool TakeMaterials(RE::TESObjectREFR::InventoryCountMap& a_inventory,
+                                         RE::BGSConstructibleObject* a_recipe) {
+            bool affordable = true;
+            a_recipe->requiredItems.ForEachContainerObject([&](RE::ContainerObject& a_item) {
+                const auto it = a_inventory.find(a_item.obj);
+                if (it == a_inventory.end() || it->second < a_item.count) {
+                    affordable = false;
+                    return RE::BSContainer::ForEachResult::kStop;
+                }
+                return RE::BSContainer::ForEachResult::kContinue;
+            });
+
+            if (affordable) {
+                a_recipe->requiredItems.ForEachContainerObject([&](RE::ContainerObject& a_item) {
+                    a_inventory[a_item.obj] -= a_item.count;
+                    return RE::BSContainer::ForEachResult::kContinue;
+                });
+            }
+            return affordable;
+        }
+
+        // What one craft took from the inventory, by object.
+        [[nodiscard]] RE::TESObjectREFR::InventoryCountMap GetConsumed(
+            const RE::TESObjectREFR::InventoryCountMap& a_before, const RE::TESObjectREFR::InventoryCountMap& a_after) {
+            RE::TESObjectREFR::InventoryCountMap consumed;
+            for (const auto& [obj, count] : a_before) {
+                const auto it = a_after.find(obj);
+                const auto remaining = it != a_after.end() ? it->second : 0;
+                if (remaining < count) {
+                    consumed.emplace(obj, count - remaining);
+                }
             }
+            return consumed;
+        }
+
+        // What a batch crafts, saved when it starts and compared before every repeat, so a batch stops instead of
+        // crafting whatever the player selected since.
+        struct Selection {
+            std::uint32_t index{0};
+            const void* recipe{nullptr};
+
+            [[nodiscard]] bool operator==(const Selection&) const = default;
         };
 
-        template <std::uint64_t FUNC_ID, std::size_t CAVE_START, std::size_t CAVE_END, std::size_t JUMP_OUT>
-        void InstallSubMenuPatch(std::uintptr_t a_skipFuncAddr) {
-            constexpr std::size_t CAVE_SIZE = CAVE_END - CAVE_START;
+        template <class T>
+        [[nodiscard]] Selection GetSelection(T* a_subMenu) {
+            const auto index = a_subMenu->highlightIndex;
+            if constexpr (std::is_same_v<T, RE::CraftingSubMenus::ConstructibleObjectMenu>) {
+                const auto& entries = a_subMenu->listEntries;
+                return {index, index < entries.size() ? entries[index].constructibleObject : nullptr};
+            } else if constexpr (std::is_same_v<T, SmithingMenu>) {
+                const auto& entries = a_subMenu->listEntries;
+                return {index, index < entries.size() ? entries[index].item : nullptr};
+            } else {
+                // the alchemy menu crafts from the picked ingredients, which the consumed items are checked against
+                return {index, nullptr};
+            }
+        }
+
+        // One craft of the running batch, returns false once the batch is done. Run by the crafting menu's update, one
+        // per frame: the engine rebuilds the whole submenu list in every craft, so running the repeats back to back
+        // would stall a single frame once per repeat.
+        std::function<bool()> batchStep;
 
-            const REL::Relocation<std::uintptr_t> funcBase{REL::ID(FUNC_ID)};
+        // Set by every craft the player starts. That frame's list rebuild is spent, the batch waits for the next one.
+        bool listDirty{false};
 
-            SubMenuPatchCode patch(a_skipFuncAddr, funcBase.address() + JUMP_OUT);
-            patch.ready();
-            assert(patch.getSize() <= CAVE_SIZE);
+        void RunBatchStep() {
+            if (std::exchange(listDirty, false) || !batchStep) {
+                return;
+            }
 
-            REL::safe_fill(funcBase.address() + CAVE_START, REL::NOP, CAVE_SIZE);
-            REL::safe_write(funcBase.address() + CAVE_START,
-                            std::span{patch.getCode<const std::byte*>(), patch.getSize()});
+            if (!batchStep()) {
+                batchStep = nullptr;
+            }
         }
 
-        void RefreshInventoryMenu() {
-            const auto ui = RE::UI::GetSingleton();
-            const auto invMenu = ui->GetMenu<RE::InventoryMenu>();
-            if (invMenu && invMenu->GetRuntimeData().itemList) {
-                invMenu->GetRuntimeData().itemList->Update();
+        // Counts of just the objects in a_cost, far cheaper than a snapshot of the whole inventory.
+        [[nodiscard]] RE::TESObjectREFR::InventoryCountMap GetCounts(
+            const RE::TESObjectREFR::InventoryCountMap& a_cost) {
+            return RE::PlayerCharacter::GetSingleton()->GetInventoryCounts(
+                [&](RE::TESBoundObject& a_object) { return a_cost.contains(std::addressof(a_object)); });
+        }
+
+        // Queues a_repeats more crafts of what the player just crafted. a_repeats is already bounded by the materials,
+        // so the repeats take no inventory snapshots. The batch stops when the menu closes, another prompt is skipped,
+        // the selection changes, or an improvement is no longer possible. The alchemy menu crafts from the picked
+        // ingredients, which the highlight does not show, so there a craft that consumes something else than the
+        // first one stops the batch as well.
+        template <class T, Patches::Callback SKIP_FUNC>
+        void StartBatch(T* a_subMenu, RE::TESObjectREFR::InventoryCountMap a_cost, std::int64_t a_repeats) {
+            const auto selection = GetSelection(a_subMenu);
+            batchStep = [=, cost = std::move(a_cost), crafted = std::int64_t{1}]() mutable {
+                if (Menus::GetCraftingSubMenu() != a_subMenu || GetSelection(a_subMenu) != selection) {
+                    logger::debug("Batch crafted {} items, cancelled"sv, crafted);
+                    return false;
+                }
+
+                if constexpr (std::is_same_v<T, SmithingMenu>) {
+                    const auto& entries = a_subMenu->listEntries;
+                    if (selection.index >= entries.size() || !IsImprovable(entries[selection.index])) {
+                        logger::debug("Batch improved {} times"sv, crafted);
+                        return false;
+                    }
+                }
+
+                REL::Relocation<void(T*)> func{callbackFuncs[std::to_underlying(SKIP_FUNC)]};
+                if constexpr (std::is_same_v<T, RE::CraftingSubMenus::AlchemyMenu>) {
+                    const auto before = GetCounts(cost);
+                    func(a_subMenu);
+                    if (GetConsumed(before, GetCounts(cost)) != cost) {
+                        logger::warn("Batch crafting stopped after {} items, the selection changed"sv, crafted + 1);
+                        return false;
+                    }
+                } else {
+                    func(a_subMenu);
+                }
+
+                if (++crafted > a_repeats) {
+                    logger::debug("Batch crafted {} items"sv, crafted);
+                    return false;
+                }
+                return true;
+            };
+        }
+
+        // After the highlighted item was improved, improves every selected item in the list as far as the materials
+        // and the player's skill and perks allow, one improvement per frame like any other batch. The selection is the
+        // same mark the disenchant batch uses, plus whatever the player is wearing. The material budget comes from one
+        // inventory snapshot and is drawn down by each improvement's recipe. The engine rebuilds the list after each
+        // improvement and splits improved copies off their stack, so each step looks the object up again and improves
+        // whichever of its selected entries can still be improved. The tiers bound the steps per copy in case an entry
+        // never reports being done.
+        void StartTemperAll(SmithingMenu* a_subMenu, const REL::Relocation<void(SmithingMenu*)>& a_func) {
+            auto inventory = RE::PlayerCharacter::GetSingleton()->GetInventoryCounts();
+
+            std::vector<std::pair<RE::TESBoundObject*, std::int64_t>> queue;  // each object with its remaining steps
+            for (const auto& entry : a_subMenu->listEntries) {
+                if (!entry.item || !IsSelected(entry.item)) {
+                    continue;
+                }
+
+                const auto object = entry.item->object;
+                if (object && std::ranges::find(queue, object, &decltype(queue)::value_type::first) == queue.end()) {
+                    const auto it = inventory.find(object);
+                    const std::int64_t copies = it != inventory.end() ? std::max(it->second, 1) : 1;
+                    queue.emplace_back(object, copies * MAX_TEMPER_TIERS);
+                }
             }
+
+            batchStep = [=, next = std::size_t{0}, improved = std::size_t{0}]() mutable {
+                if (Menus::GetCraftingSubMenu() != a_subMenu) {
+                    logger::debug("Tempered {} additional times, cancelled"sv, improved);
+                    return false;
+                }
+
+                for (; next < queue.size(); ++next) {
+                    auto& [object, steps] = queue[next];
+                    const auto& entries = a_subMenu->listEntries;
+                    const auto it = std::ranges::find_if(entries, [&](const SmithingMenu::SmithingItemEntry& a_entry) {
+                        return a_entry.item && a_entry.item->object == object && IsSelected(a_entry.item) &&
+                               IsImprovable(a_entry);
+                    });
+                    if (steps <= 0 || it == entries.end() || !TakeMaterials(inventory, it->constructibleObject)) {
+                        continue;
+                    }
+
+                    --steps;
+                    a_subMenu->highlightIndex = static_cast<std::uint32_t>(std::distance(entries.begin(), it));
+                    a_func(a_subMenu);
+                    ++improved;
+                    return true;
+                }
+
+                logger::debug("Tempered {} additional times"sv, improved);
+                return false;
+            };
         }
 
-        RE::InventoryEntryData* GetEquippedEntryData(RE::AIProcess* a_process, [[maybe_unused]] bool a_leftHand) {
-            const auto middleHigh = a_process->middleHigh;
-            if (!middleHigh) {
-                return nullptr;
+        // After the highlighted item was disenchanted, disenchants one more disposable item for every enchantment the
+        // player still does not know, one per frame like any other batch. The engine rebuilds the list after each
+        // disenchant, so entries are matched by the inventory entry they wrap rather than by index, and an entry is
+        // only looked at once it is found in the current list.
+        void StartDisenchantUnknown(EnchantConstructMenu* a_subMenu,
+                                    const REL::Relocation<void(EnchantConstructMenu*)>& a_func) {
+            using ItemChangeEntry = EnchantConstructMenu::ItemChangeEntry;
+
+            std::vector<RE::InventoryEntryData*> queue;
+            std::unordered_set<const RE::EnchantmentItem*> queued;
+            for (const auto& entry : a_subMenu->listEntries) {
+                if (!entry || !IsDisenchantEntry(*entry)) {
+                    continue;
+                }
+
+                const auto data = static_cast<ItemChangeEntry*>(entry.get())->data;
+                const auto enchantment = GetBaseEnchantment(data);
+                if (enchantment && !enchantment->GetKnown() && IsDisposable(data) &&
+                    queued.insert(enchantment).second) {
+                    queue.push_back(data);
+                }
             }
 
-            const auto hand = middleHigh->rightHand;
-            if (hand && hand->object && hand->object->Is(RE::FormType::Weapon)) {
-                if (!hand->extraLists) {
-                    return hand;
+            batchStep = [=, next = std::size_t{0}, disenchanted = std::size_t{0}]() mutable {
+                if (Menus::GetCraftingSubMenu() != a_subMenu) {
+                    logger::debug("Batch disenchanted {} additional items, cancelled"sv, disenchanted);
+                    return false;
                 }
 
-                bool applied = false;
-                for (auto& xList : *hand->extraLists) {
-                    if (xList->HasType(RE::ExtraDataType::kPoison)) {
-                        applied = true;
-                        break;
+                for (; next < queue.size(); ++next) {
+                    const auto data = queue[next];
+                    const auto& entries = a_subMenu->listEntries;
+                    const auto it = std::ranges::find_if(entries, [&](const auto& a_entry) {
+                        return a_entry && IsDisenchantEntry(*a_entry) &&
+                               static_cast<ItemChangeEntry*>(a_entry.get())->data == data;
+                    });
+                    if (it == entries.end()) {
+                        continue;
+                    }
+
+                    const auto enchantment = GetBaseEnchantment(data);
+                    if (!enchantment || enchantment->GetKnown() || !IsDisposable(data)) {
+                        continue;
                     }
+
+                    a_subMenu->highlightIndex = static_cast<std::uint32_t>(std::distance(entries.begin(), it));
+                    a_func(a_subMenu);
+                    ++disenchanted;
+                    ++next;
+                    return true;
+                }
+
+                logger::debug("Batch disenchanted {} additional items"sv, disenchanted);
+                return false;
+            };
+        }
+
+        template <class T, Patches::Callback SKIP_FUNC>
+        void SkipSubMenuMenuPrompt() {
+            Stats::Timer timer{SKIP_FUNC};
+            REL::Relocation<void(T*)> func{callbackFuncs[std::to_underlying(SKIP_FUNC)]};
+            const auto subMenu = static_cast<T*>(Menus::GetCraftingSubMenu());
+            batchStep = nullptr;
+            listDirty = true;
+            if (!subMenu) {
+                logger::warn("Skipped a crafting prompt without an open crafting menu"sv);
+                return;
+            }
+
+            if constexpr (SKIP_FUNC == Patches::Callback::kEnchantmentLearned) {
+                func(subMenu);
+                if (*Settings::BatchDisenchant) {
+                    StartDisenchantUnknown(subMenu, func);
+                }
+                return;
+            }
+
+            if constexpr (std::is_same_v<T, SmithingMenu>) {
+                if (*Settings::TemperAll) {
+                    func(subMenu);
+                    StartTemperAll(subMenu, func);
+                    return;
                 }
+            }
+
+            const auto quantity = *Settings::BatchQuantity;
+            if (quantity <= 1 || !IsBatchEnabled<T>()) {
+                func(subMenu);
+                return;
+            }
+
+            // the first craft runs right away and tells us what a single craft costs, the rest are bounded by that
+            // budget and spread over the following frames
+            const auto player = RE::PlayerCharacter::GetSingleton();
+            const auto before = player->GetInventoryCounts();
+            func(subMenu);
+            const auto after = player->GetInventoryCounts();
+
+            const auto remaining = std::min(quantity - 1, GetBatchBudget(before, after));
+            if (remaining > 0) {
+                StartBatch<T, SKIP_FUNC>(subMenu, GetConsumed(before, after), remaining);
+            }
+        }
+
+        [[nodiscard]] RE::ExtraPoison* GetPoison(RE::InventoryEntryData* a_entry) {
+            if (!a_entry || !a_entry->extraLists) {
+                return nullptr;
+            }
 
-                if (!applied) {
-                    return hand;
+            for (auto& xList : *a_entry->extraLists) {
+                if (const auto xPoison = xList ? xList->GetByType<RE::ExtraPoison>() : nullptr) {
+                    return xPoison;
                 }
             }
+            return nullptr;
+        }
 
-            return middleHigh->leftHand ? middleHigh->leftHand : middleHigh->rightHand;
+        [[nodiscard]] bool IsWeapon(const RE::InventoryEntryData* a_entry) {
+            return a_entry && a_entry->object && a_entry->object->Is(RE::FormType::Weapon);
         }
 
-        void InstallPoisonPatch() {
-            constexpr std::size_t JUMP_OUT = 0x148;
+        // Where the poison goes, worked out once per pair of equipped hands. The engine asks for it more than once per
+        // application, the target is kept for the rest of that application.
+        struct PoisonTarget {
+            const RE::InventoryEntryData* right{nullptr};
+            const RE::InventoryEntryData* left{nullptr};
+            RE::InventoryEntryData* entry{nullptr};      // what the engine poisons
+            RE::InventoryEntryData* otherHand{nullptr};  // an unpoisoned weapon in the other hand, if any
+            bool valid{false};
+        };
 
-            const REL::Relocation<std::uintptr_t> funcBase{RELOCATION_ID(39406, 40481)};
+        PoisonTarget poisonTarget;
 
-            // nop until callback gets loaded
-            {
-                constexpr std::size_t CAVE_START = 0xA3;
-                constexpr std::size_t CAVE_END = 0xD7;
-                REL::safe_fill(funcBase.address() + CAVE_START, REL::NOP, CAVE_END - CAVE_START);
+        [[nodiscard]] const PoisonTarget& GetPoisonTarget(RE::MiddleHighProcessData* a_middleHigh) {
+            const auto right = a_middleHigh->rightHand;
+            const auto left = a_middleHigh->leftHand;
+            if (poisonTarget.valid && poisonTarget.right == right && poisonTarget.left == left) {
+                return poisonTarget;
             }
 
-            // hook callback
-            {
-                constexpr std::size_t CAVE_START = 0xDE;
-                constexpr std::size_t CAVE_END = 0x112;
-                constexpr std::size_t CAVE_SIZE = CAVE_END - CAVE_START;
+            // each hand's extra lists are scanned once
+            const bool rightPoisonable = IsWeapon(right) && !GetPoison(right);
+            const bool leftPoisonable = left && left != right && IsWeapon(left) && !GetPoison(left);
 
-                struct Patch : public Xbyak::CodeGenerator {
-                public:
-                    Patch(std::size_t a_callAddr, std::size_t a_retAddr) {
-                        Xbyak::Label callLbl;
-                        Xbyak::Label retLbl;
+            poisonTarget = {right, left, nullptr, nullptr, true};
+            if (rightPoisonable) {
+                poisonTarget.entry = right;
+                poisonTarget.otherHand = leftPoisonable ? left : nullptr;
+            } else {
+                poisonTarget.entry = left ? left : right;
+            }
+            return poisonTarget;
+        }
 
-                        mov(rcx, 2);
-                        call(rdx);
-                        call(ptr[rip + callLbl]);
-                        jmp(ptr[rip + retLbl]);
+        // weapon entries the current poison is applied to, as picked by GetPoisonedEntry
+        RE::InventoryEntryData* poisonedEntry = nullptr;
+        RE::InventoryEntryData* otherHandEntry = nullptr;
 
-                        L(callLbl);
-                        dq(a_callAddr);
+        // The poison being applied, read from the selected list item by GetPoisonedEntry while the stack still
+        // exists. The engine's dose may free the last one, so nothing reads the list item's entry after that.
+        RE::AlchemyItem* selectedPoison = nullptr;
 
-                        L(retLbl);
-                        dq(a_retAddr);
-                    }
-                };
+        [[nodiscard]] RE::AlchemyItem* GetSelectedPoison() {
+            const auto invMenu = Menus::GetInventoryMenu();
+            const auto itemList = invMenu ? invMenu->GetRuntimeData().itemList : nullptr;
+            const auto selected = itemList ? itemList->GetSelectedItem() : nullptr;
+            const auto object = selected && selected->data.objDesc ? selected->data.objDesc->object : nullptr;
+            return object ? object->As<RE::AlchemyItem>() : nullptr;
+        }
 
-                Patch patch(reinterpret_cast<std::uintptr_t>(&RefreshInventoryMenu), funcBase.address() + JUMP_OUT);
-                patch.ready();
-                assert(patch.getSize() <= CAVE_SIZE);
+        [[nodiscard]] std::int32_t GetItemCount(RE::TESBoundObject* a_object) {
+            const auto counts = RE::PlayerCharacter::GetSingleton()->GetInventoryCounts(
+                [&](RE::TESBoundObject& a_candidate) { return std::addressof(a_candidate) == a_object; });
+            const auto it = counts.find(a_object);
+            return it != counts.end() ? it->second : 0;
+        }
 
-                REL::safe_fill(funcBase.address() + CAVE_START, REL::NOP, CAVE_SIZE);
-                REL::safe_write(funcBase.address() + CAVE_START,
-                                std::span{patch.getCode<const std::byte*>(), patch.getSize()});
+        [[nodiscard]] RE::ItemList::Item* FindListItem(RE::ItemList* a_itemList,
+                                                       const RE::InventoryEntryData* a_entry) {
+            for (const auto item : a_itemList->items) {
+                if (item && item->data.objDesc == a_entry) {
+                    return item;
+                }
             }
+            return nullptr;
+        }
 
-            // swap messagebox error for debug notification
-            {
-                constexpr std::size_t CAVE_START = 0x119;
-                constexpr std::size_t CAVE_END = 0x148;
-                constexpr std::size_t CAVE_SIZE = CAVE_END - CAVE_START;
+        // Uses more of the selected poison on top of the dose the engine just applied: PoisonDoses doses per weapon,
+        // and the other hand as well with PoisonBothHands. Every extra poison adds as many charges as the engine's
+        // application did, so perks that raise the charges per dose apply to all of them.
+        void ApplyExtraPoison(RE::AlchemyItem* a_poison) {
+            const auto applied = GetPoison(poisonedEntry);
+            if (!a_poison || !applied || applied->poison != a_poison) {
+                return;
+            }
 
-                struct Patch : public Xbyak::CodeGenerator {
-                public:
-                    Patch(std::size_t a_callAddr, std::size_t a_retAddr) {
-                        Xbyak::Label callLbl;
-                        Xbyak::Label retLbl;
+            const auto player = RE::PlayerCharacter::GetSingleton();
+            const auto charges = applied->count;
+            auto remaining = GetItemCount(a_poison);
+            const auto consume = [&]() {
+                if (remaining <= 0) {
+                    return false;
+                }
+                player->RemoveItem(a_poison, 1, RE::ITEM_REMOVE_REASON::kRemove, nullptr, nullptr);
+                --remaining;
+                return true;
+            };
+
+            const auto doses = std::max<std::int64_t>(*Settings::PoisonDoses, 1);
+            for (std::int64_t i = 1; i < doses && consume(); ++i) {
+                applied->count += charges;
+            }
 
-                        mov(rdx, 0);
-                        mov(r8, 1);
-                        call(ptr[rip + callLbl]);
-                        jmp(ptr[rip + retLbl]);
+            if (!*Settings::PoisonBothHands || !otherHandEntry || !consume()) {
+                otherHandEntry = nullptr;
+                return;
+            }
 
-                        L(callLbl);
-                        dq(a_callAddr);
+            otherHandEntry->PoisonObject(a_poison, charges);
+            const auto other = GetPoison(otherHandEntry);
+            for (std::int64_t i = 1; other && i < doses && consume(); ++i) {
+                other->count += charges;
+            }
+        }
 
-                        L(retLbl);
-                        dq(a_retAddr);
-                    }
-                };
+        // Updates the entries of the poisoned weapons and the consumed poison in place. Returns false when the list
+        // has to be rebuilt instead: an entry is missing, or the poison stack ran out and its entry has to go. The
+        // remaining count comes from the inventory, the selected list item's entry may already be freed.
+        [[nodiscard]] bool UpdatePoisonedEntries(RE::ItemList* a_itemList, RE::AlchemyItem* a_poison) {
+            const auto poison = a_itemList->GetSelectedItem();
+            if (!poison || !a_poison || !poisonedEntry) {
+                return false;
+            }
 
-                const REL::Relocation<std::uintptr_t> dbgNotif{REL::ID(52933)};
-                Patch patch(dbgNotif.address(), funcBase.address() + JUMP_OUT);
-                patch.ready();
-                assert(patch.getSize() <= CAVE_SIZE);
+            const auto count = GetItemCount(a_poison);
+            if (count <= 0) {
+                return false;
+            }
 
-                REL::safe_fill(funcBase.address() + CAVE_START, REL::NOP, CAVE_SIZE);
-                REL::safe_write(funcBase.address() + CAVE_START,
-                                std::span{patch.getCode<const std::byte*>(), patch.getSize()});
+            const auto weapon = FindListItem(a_itemList, poisonedEntry);
+            const auto otherWeapon = otherHandEntry ? FindListItem(a_itemList, otherHandEntry) : nullptr;
+            if (!weapon || (otherHandEntry && !otherWeapon)) {
+                return false;
             }
 
-            // Fix for applying poison to left hand
-            {
-                auto& trampoline = SKSE::GetTrampoline();
-                trampoline.write_call<5>(funcBase.address() + 0x2F, &GetEquippedEntryData);
+            poison->obj.SetMember("count", count);
+            weapon->obj.SetMember("isPoisoned", true);
+            if (otherWeapon) {
+                otherWeapon->obj.SetMember("isPoisoned", true);
+            }
+            a_itemList->root.Invoke("InvalidateData");
+            return true;
+        }
 
-                const REL::Relocation<std::uintptr_t> funcBase2{RELOCATION_ID(39407, 40482)};
-                trampoline.write_call<5>(funcBase2.address() + 0x32, &GetEquippedEntryData);
+        // Called once per activation, after the engine applied the first dose, so the list is updated a single time
+        // however many doses went on.
+        void RefreshInventoryMenu() {
+            Stats::Timer timer{Patches::Callback::kRefreshInventoryMenu};
+            const auto invMenu = Menus::GetInventoryMenu();
+            const auto itemList = invMenu ? invMenu->GetRuntimeData().itemList : nullptr;
+            if (itemList) {
+                ApplyExtraPoison(selectedPoison);
+                if (!UpdatePoisonedEntries(itemList, selectedPoison)) {
+                    itemList->Update();
+                }
             }
+            selectedPoison = nullptr;
+            poisonedEntry = nullptr;
+            otherHandEntry = nullptr;
+            poisonTarget.valid = false;
+        }
 
-            logger::debug("Installed poison patch"sv);
+        [[nodiscard]] RE::InventoryEntryData* GetPoisonedEntry(RE::AIProcess* a_process) {
+            const auto middleHigh = a_process->middleHigh;
+            if (!middleHigh) {
+                return nullptr;
+            }
+
+            const auto& target = GetPoisonTarget(middleHigh);
+            if (!selectedPoison) {
+                // the first call of an application comes before the dose is taken, later ones may not
+                selectedPoison = GetSelectedPoison();
+            }
+            poisonedEntry = target.entry;
+            otherHandEntry = target.otherHand;
+            return poisonedEntry;
         }
 
-        void NotifyEnchantmentLearned(const char* a_fmt, RE::TESForm* a_item) {
-            const auto fullName = a_item->As<RE::TESFullName>();
-            const auto name = fullName ? fullName->GetFullName() : "";
-            std::size_t len = std::snprintf(0, 0, a_fmt, name) + 1;
-            const auto msg = std::make_unique<char[]>(len);
-            std::snprintf(msg.get(), len, a_fmt, name);
-            RE::DebugNotification(msg.get());
-        }
-
-        void InstallEnchantmentLearnedPatch(const bool isSE) {
-
-            // skip "are you sure?"
-            {
-                if (isSE) {
-                    constexpr std::uint64_t SKIP_FUNC = 50459;
-                    constexpr std::uint64_t CALL_FUNC = 50440;
-                    constexpr std::size_t CAVE_START = 0xBB;
-                    constexpr std::size_t CAVE_END = 0x1D3;
-                    constexpr std::size_t JUMP_OUT = 0x38D;
-                    const auto fnAddr = reinterpret_cast<std::uintptr_t>(
-                        SkipSubMenuMenuPrompt<RE::CraftingSubMenus::EnchantConstructMenu, SKIP_FUNC>);
-                    InstallSubMenuPatch<CALL_FUNC, CAVE_START, CAVE_END, JUMP_OUT>(fnAddr);
-                } else {
-                    constexpr std::uint64_t SKIP_FUNC = 51363;
-                    constexpr std::uint64_t CALL_FUNC = 51344;
-                    constexpr std::size_t CAVE_START = 0xC2;
-                    constexpr std::size_t CAVE_END = 0x1D7;
-                    constexpr std::size_t JUMP_OUT = 0x4DF;
-                    const auto fnAddr = reinterpret_cast<std::uintptr_t>(
-                        SkipSubMenuMenuPrompt<RE::CraftingSubMenus::EnchantConstructMenu, SKIP_FUNC>);
-                    InstallSubMenuPatch<CALL_FUNC, CAVE_START, CAVE_END, JUMP_OUT>(fnAddr);
-				}
-                
-            }
-
-            const REL::Relocation<std::uintptr_t> funcBase{RELOCATION_ID(50459, 51363)};
-
-            // nop until format string gets loaded
-            {
-                constexpr std::size_t CAVE_START = 0x15D;
-                constexpr std::size_t CAVE_END = 0x1A7;
-                REL::safe_fill(funcBase.address() + CAVE_START, REL::NOP, CAVE_END - CAVE_START);
-            }
-
-            // swap messagebox for debug notification
-            {
-                constexpr std::size_t CAVE_START = 0x1AE;
-                constexpr std::size_t CAVE_END = 0x1EB;
-                constexpr std::size_t CAVE_SIZE = CAVE_END - CAVE_START;
-
-                struct Patch : public Xbyak::CodeGenerator {
-                public:
-                    Patch(std::size_t a_callAddr, std::size_t a_retAddr) {
-                        Xbyak::Label callLbl;
-                        Xbyak::Label retLbl;
-
-                        mov(rcx, rbx);  // rbx == const char*
-                        mov(rdx, rsi);  // rsi == TESForm*
-                        call(ptr[rip + callLbl]);
-                        jmp(ptr[rip + retLbl]);
-
-                        L(callLbl);
-                        dq(a_callAddr);
-
-                        L(retLbl);
-                        dq(a_retAddr);
-                    }
-                };
+        RE::InventoryEntryData* GetEquippedEntryData(RE::AIProcess* a_process, [[maybe_unused]] bool a_leftHand) {
+            Stats::Timer timer{Patches::Callback::kGetEquippedEntryData};
+            return GetPoisonedEntry(a_process);
+        }
+
+        // The first call of every application. Drops whatever the previous one left behind: an application the
+        // engine refuses, such as on an already poisoned weapon, ends without reaching RefreshInventoryMenu, and a
+        // cached target may be stale once a poison wore off in combat.
+        RE::InventoryEntryData* BeginPoisonApplication(RE::AIProcess* a_process, [[maybe_unused]] bool a_leftHand) {
+            Stats::Timer timer{Patches::Callback::kBeginPoisonApplication};
+            selectedPoison = nullptr;
+            poisonedEntry = nullptr;
+            otherHandEntry = nullptr;
+            poisonTarget.valid = false;
+            return GetPoisonedEntry(a_process);
+        }
 
-                constexpr std::size_t JUMP_OUT = 0x1EB;
-                Patch patch(reinterpret_cast<std::uintptr_t>(NotifyEnchantmentLearned), funcBase.address() + JUMP_OUT);
-                patch.ready();
-                assert(patch.getSize() <= CAVE_SIZE);
+        // The timing is read from the settings on every use, so a reload applies to the next message.
+        [[nodiscard]] Notifications::Coalescer& GetLearnedNotifications() {
+            using Notifications::Coalescer;
+            const auto toDuration = [](double a_seconds) {
+                return std::chrono::duration_cast<Coalescer::duration>(std::chrono::duration<double>{a_seconds});
+            };
 
-                REL::safe_fill(funcBase.address() + CAVE_START, REL::NOP, CAVE_SIZE);
-                REL::safe_write(funcBase.address() + CAVE_START,
-                                std::span{patch.getCode<const std::byte*>(), patch.getSize()});
+            static Coalescer coalescer{Coalescer::duration::zero(), Coalescer::duration::zero()};
+            coalescer.SetTiming(toDuration(*Settings::CoalesceWindow), toDuration(*Settings::NotificationInterval));
+            return coalescer;
+        }
+
+        // Runs once per frame from the HUD's update, shows the next merged message once it is due.
+        void FlushLearnedNotifications() {
+            auto& notifications = GetLearnedNotifications();
+            if (!notifications.pending()) {
+                return;
             }
 
-            logger::debug("Installed enchantment learned patch"sv);
+            const auto msg = notifications.Poll(Notifications::Coalescer::clock_type::now());
+            if (!msg.empty()) {
+                RE::DebugNotification(msg.data());
+            }
+        }
+
+        void NotifyEnchantmentLearned(const char* a_fmt, RE::TESForm* a_item) {
+            Stats::Timer timer{Patches::Callback::kNotifyEnchantmentLearned};
+            const auto fullName = a_item->As<RE::TESFullName>();
+            const auto name = fullName ? fullName->GetFullName() : "";
+            GetLearnedNotifications().Push(a_fmt ? a_fmt : "%s", name, Notifications::Coalescer::clock_type::now());
         }
 
         void CloseEnchantingMenu() {
+            Stats::Timer timer{Patches::Callback::kCloseEnchantingMenu};
             const auto uiStr = RE::InterfaceStrings::GetSingleton();
             const auto factory = RE::MessageDataFactoryManager::GetSingleton();
             const auto creator = factory->GetCreator<RE::BSUIMessageData>(uiStr->bsUIMessageData);
@@ -265,138 +614,331 @@ namespace Hooks {
             const auto uiQueue = RE::UIMessageQueue::GetSingleton();
             uiQueue->AddMessage(uiStr->craftingMenu, RE::UI_MESSAGE_TYPE::kUserEvent, msg);
         }
+
+        [[nodiscard]] bool IsEnabled(Patches::Patch a_patch) {
+            switch (a_patch) {
+                case Patches::Patch::kConstructibleObjectMenu:
+                    return *Settings::ConstructibleObjectMenu;
+                case Patches::Patch::kAlchemyMenu:
+                    return *Settings::AlchemyMenu;
+                case Patches::Patch::kSmithingMenu:
+                    return *Settings::SmithingMenu;
+                case Patches::Patch::kEnchantmentLearned:
+                    return *Settings::EnchantmentLearned;
+                case Patches::Patch::kEnchantmentCrafted:
+                    return *Settings::EnchantmentCrafted;
+                case Patches::Patch::kEnchantingMenuExit:
+                    return *Settings::EnchantingMenuExit;
+                case Patches::Patch::kPoison:
+                    return *Settings::Poison;
+                default:
+                    return false;
+            }
+        }
+
+        [[nodiscard]] std::uintptr_t GetCallbackAddress(Patches::Callback a_callback) {
+            using Callback = Patches::Callback;
+            using namespace RE::CraftingSubMenus;
+
+            switch (a_callback) {
+                case Callback::kConstructibleObjectMenu:
+                    return reinterpret_cast<std::uintptr_t>(
+                        SkipSubMenuMenuPrompt<ConstructibleObjectMenu, Callback::kConstructibleObjectMenu>);
+                case Callback::kAlchemyMenu:
+                    return reinterpret_cast<std::uintptr_t>(SkipSubMenuMenuPrompt<AlchemyMenu, Callback::kAlchemyMenu>);
+                case Callback::kSmithingMenu:
+                    return reinterpret_cast<std::uintptr_t>(
+                        SkipSubMenuMenuPrompt<SmithingMenu, Callback::kSmithingMenu>);
+                case Callback::kEnchantmentLearned:
+                    return reinterpret_cast<std::uintptr_t>(
+                        SkipSubMenuMenuPrompt<EnchantConstructMenu, Callback::kEnchantmentLearned>);
+                case Callback::kEnchantmentCrafted:
+                    return reinterpret_cast<std::uintptr_t>(
+                        SkipSubMenuMenuPrompt<EnchantConstructMenu, Callback::kEnchantmentCrafted>);
+                case Callback::kCloseEnchantingMenu:
+                    return reinterpret_cast<std::uintptr_t>(CloseEnchantingMenu);
+                case Callback::kRefreshInventoryMenu:
+                    return reinterpret_cast<std::uintptr_t>(RefreshInventoryMenu);
+                case Callback::kNotifyEnchantmentLearned:
+                    return reinterpret_cast<std::uintptr_t>(NotifyEnchantmentLearned);
+                case Callback::kGetEquippedEntryData:
+                    return reinterpret_cast<std::uintptr_t>(GetEquippedEntryData);
+                case Callback::kBeginPoisonApplication:
+                    return reinterpret_cast<std::uintptr_t>(BeginPoisonApplication);
+                case Callback::kDebugNotification:
+                    return callbackFuncs[std::to_underlying(a_callback)];
+                default:
+                    return 0;
+            }
+        }
+
+        [[nodiscard]] std::span<const std::byte> GetTextSegment() {
+            const auto text = REL::Module::get().segment(REL::Segment::textx);
+            return {text.pointer<const std::byte>(), text.size()};
+        }
+
+        // Trampolines written by other plugins jump out of the executable's code, ours never do.
+        [[nodiscard]] bool IsDetoured(std::uintptr_t a_address, std::size_t a_size) {
+            constexpr Signature::Pattern ABS_JMP{"FF 25 00 00 00 00"sv};
+            const auto code = reinterpret_cast<const std::byte*>(a_address);
+            if (ABS_JMP.Find({code, a_size})) {
+                return true;
+            }
+
+            if (code[0] != std::byte{0xE9}) {
+                return false;
+            }
+
+            std::int32_t disp;
+            std::memcpy(&disp, code + 1, sizeof(disp));
+            const auto target = reinterpret_cast<const std::byte*>(a_address + 5 + disp);
+            const auto text = GetTextSegment();
+            return target < text.data() || target >= text.data() + text.size();
+        }
+
+        // Checks a cave before anything is written to it.
+        [[nodiscard]] bool VerifyCave(const Patches::Cave& a_cave, std::uintptr_t a_funcBase) {
+            if (IsDetoured(a_funcBase + a_cave.start, a_cave.size())) {
+                logger::error("Cave {}+0x{:X} is already hooked by another plugin"sv, a_cave.funcID, a_cave.start);
+                return false;
+            }
+
+            return true;
+        }
+
+        [[nodiscard]] Patches::Runtime GetRuntime() {
+            return REL::Module::GetRuntime() != REL::Module::Runtime::AE ? Patches::Runtime::kSE
+                                                                         : Patches::Runtime::kAE;
+        }
+
+        // A jmp [rip] to a_dst in trampoline memory, so game code can reach it with a rel32 call. Allocated once per
+        // destination and kept across reinstalls.
+        [[nodiscard]] std::uintptr_t GetTrampolineJump(std::uintptr_t a_dst) {
+            static std::unordered_map<std::uintptr_t, std::uintptr_t> jumps;
+
+            const auto [it, inserted] = jumps.try_emplace(a_dst, 0);
+            if (inserted) {
+                constexpr std::array<std::uint8_t, 6> JMP{0xFF, 0x25, 0x00, 0x00, 0x00, 0x00};
+                const auto mem = static_cast<std::byte*>(SKSE::GetTrampoline().allocate(JMP.size() + sizeof(a_dst)));
+                std::memcpy(mem, JMP.data(), JMP.size());
+                std::memcpy(mem + JMP.size(), &a_dst, sizeof(a_dst));
+                it->second = reinterpret_cast<std::uintptr_t>(mem);
+            }
+            return it->second;
+        }
+
+        struct PatchState {
+            bool installed{false};
+            std::vector<Patches::PatchTransaction::Edit> edits;  // what was written, with the original bytes
+        };
+
+        std::array<PatchState, std::to_underlying(Patches::Patch::kTotal)> patchStates;
+
+        // patches whose menu has opened at least once, only consulted with DeferInstall
+        std::array<bool, std::to_underlying(Patches::Patch::kTotal)> menuSeen{};
+
+        [[nodiscard]] bool IsDue(Patches::Patch a_patch) {
+            return !*Settings::DeferInstall || menuSeen[std::to_underlying(a_patch)];
+        }
+
+        template <class T>
+        [[nodiscard]] bool IsSubMenu(const RE::CraftingSubMenus::CraftingSubMenu* a_subMenu) {
+            return *reinterpret_cast<const std::uintptr_t*>(a_subMenu) == T::VTABLE[0].address();
+        }
+
+        // Arms the patches of the menu that just opened and installs them. The patched code only runs on input
+        // handled by the menu, which comes after its open event, so the menu never sees a half written patch.
+        void OnMenuOpen(Menus::Menu a_menu) {
+            using Patch = Patches::Patch;
+            using namespace RE::CraftingSubMenus;
+
+            std::vector<Patch> patches;
+            if (a_menu == Menus::Menu::kInventory) {
+                patches = {Patch::kPoison};
+            } else if (const auto subMenu = Menus::GetCraftingSubMenu()) {
+                if (IsSubMenu<ConstructibleObjectMenu>(subMenu)) {
+                    patches = {Patch::kConstructibleObjectMenu};
+                } else if (IsSubMenu<AlchemyMenu>(subMenu)) {
+                    patches = {Patch::kAlchemyMenu};
+                } else if (IsSubMenu<SmithingMenu>(subMenu)) {
+                    patches = {Patch::kSmithingMenu};
+                } else if (IsSubMenu<EnchantConstructMenu>(subMenu)) {
+                    patches = {Patch::kEnchantmentLearned, Patch::kEnchantmentCrafted, Patch::kEnchantingMenuExit};
+                }
+            }
+
+            if (a_menu == Menus::Menu::kCrafting) {
+                batchStep = nullptr;
+            }
+
+            bool armed = false;
+            for (const auto patch : patches) {
+                armed |= !std::exchange(menuSeen[std::to_underlying(patch)], true);
+            }
+
+            if (armed && *Settings::DeferInstall) {
+                Sync();
+                logger::debug("Deferred install profile: {}"sv, Profiler::Flush());
+            }
+        }
+
+        // time QueuePatch spends in address library lookups and cave checks, and in building the bytes to write
+        Profiler::duration resolveTime{};
+        Profiler::duration codegenTime{};
+
+        // Resolves and verifies everything a_patch writes and queues it on a_transaction, each cave as a single edit.
+        // Nothing is queued unless every cave and call site checks out, a patch is applied all or nothing.
+        [[nodiscard]] bool QueuePatch(Patches::Patch a_patch, Patches::PatchTransaction& a_transaction) {
+            const auto runtime = GetRuntime();
+
+            std::vector<std::pair<std::uintptr_t, std::vector<std::byte>>> writes;
+            for (const auto& cave : Patches::GetCaves(runtime)) {
+                if (cave.patch != a_patch) {
+                    continue;
+                }
+
+                std::uintptr_t funcBase = 0;
+                {
+                    Profiler::AccumulatingTimer timer{resolveTime};
+                    funcBase = REL::ID(cave.funcID).address();
+                    if (!VerifyCave(cave, funcBase)) {
+                        return false;
+                    }
+
+                    if (cave.callbackID != 0) {
+                        callbackFuncs[std::to_underlying(cave.callback)] = REL::ID(cave.callbackID).address();
+                    }
+                }
+
+                Profiler::AccumulatingTimer timer{codegenTime};
+                std::vector<std::byte> image(cave.size(), static_cast<std::byte>(REL::NOP));
+                const auto& thunk = Patches::GetThunkTemplate(cave.thunk);
+                const auto code = thunk.Instantiate(GetCallbackAddress(cave.callback), funcBase + cave.jumpOut);
+                std::copy_n(code.begin(), thunk.size(), image.begin());
+                writes.emplace_back(funcBase + cave.start, std::move(image));
+            }
+
+            for (const auto& site : Patches::GetCallSites(runtime)) {
+                if (site.patch != a_patch) {
+                    continue;
+                }
+
+                std::uintptr_t address = 0;
+                {
+                    Profiler::AccumulatingTimer timer{resolveTime};
+                    address = REL::ID(site.funcID).address() + site.offset;
+                    if (!Signature::Pattern{site.signature}.Match(reinterpret_cast<const std::byte*>(address))) {
+                        logger::error("Call site {}+0x{:X} does not match its signature"sv, site.funcID, site.offset);
+                        return false;
+                    }
+                }
+
+                Profiler::AccumulatingTimer timer{codegenTime};
+                const auto jump = GetTrampolineJump(GetCallbackAddress(site.callback));
+                const auto disp = static_cast<std::int64_t>(jump) - static_cast<std::int64_t>(address + 5);
+                assert(disp >= std::numeric_limits<std::int32_t>::min() &&
+                       disp <= std::numeric_limits<std::int32_t>::max());
+
+                const auto rel32 = static_cast<std::int32_t>(disp);
+                std::vector<std::byte> call(5, std::byte{0xE8});
+                std::memcpy(call.data() + 1, &rel32, sizeof(rel32));
+                writes.emplace_back(address, std::move(call));
+            }
+
+            for (const auto& [address, bytes] : writes) {
+                a_transaction.Write(address, bytes);
+            }
+
+            return true;
+        }
+
+        // Restores the original bytes of an installed patch.
+        void Uninstall(Patches::Patch a_patch) {
+            auto& state = patchStates[std::to_underlying(a_patch)];
+
+            Patches::PatchTransaction transaction;
+            for (const auto& edit : std::views::reverse(state.edits)) {
+                transaction.Write(edit.address, edit.original);
+            }
+
+            if (!transaction.Commit()) {
+                logger::error("Failed to uninstall {} patch"sv, Patches::GetPatchName(a_patch));
+                return;
+            }
+
+            state.edits.clear();
+            state.installed = false;
+            logger::debug("Uninstalled {} patch"sv, Patches::GetPatchName(a_patch));
+        }
     }  // namespace
 
-    void Install() {
-        const bool isSE = REL::Module::GetRuntime() != REL::Module::Runtime::AE;
-
-        if (*Settings::ConstructibleObjectMenu) {
-            if (isSE) {
-                constexpr std::uint64_t CALL_FUNC = 50452;
-                constexpr std::uint64_t SKIP_FUNC = 50476;
-                constexpr std::size_t CAVE_START = 0x5F;
-                constexpr std::size_t CAVE_END = 0x174;
-                constexpr std::size_t JUMP_OUT = 0x192;
-                const auto fnAddr = reinterpret_cast<std::uintptr_t>(
-                    SkipSubMenuMenuPrompt<RE::CraftingSubMenus::ConstructibleObjectMenu, SKIP_FUNC>);
-                InstallSubMenuPatch<CALL_FUNC, CAVE_START, CAVE_END, JUMP_OUT>(fnAddr);
-			} else {
-                constexpr std::uint64_t CALL_FUNC = 51357;
-                constexpr std::uint64_t SKIP_FUNC = 51369;
-                constexpr std::size_t CAVE_START = 0x5A;
-                constexpr std::size_t CAVE_END = 0x169;
-                constexpr std::size_t JUMP_OUT = 0x187;
-                const auto fnAddr = reinterpret_cast<std::uintptr_t>(
-                    SkipSubMenuMenuPrompt<RE::CraftingSubMenus::ConstructibleObjectMenu, SKIP_FUNC>);
-                InstallSubMenuPatch<CALL_FUNC, CAVE_START, CAVE_END, JUMP_OUT>(fnAddr);
-			}
-            
-            logger::debug("Installed constructible object menu patch"sv);
-        }
-
-        if (*Settings::AlchemyMenu) {
-            if (isSE) {
-                constexpr std::uint64_t CALL_FUNC = 50485;
-                constexpr std::uint64_t SKIP_FUNC = 50447;
-                constexpr std::size_t CAVE_START = 0x138;
-                constexpr std::size_t CAVE_END = 0x2A9;
-                constexpr std::size_t JUMP_OUT = 0x2AB;
-                const auto fnAddr = reinterpret_cast<std::uintptr_t>(
-                    SkipSubMenuMenuPrompt<RE::CraftingSubMenus::AlchemyMenu, SKIP_FUNC>);
-                InstallSubMenuPatch<CALL_FUNC, CAVE_START, CAVE_END, JUMP_OUT>(fnAddr);
-			} else {
-                constexpr std::uint64_t CALL_FUNC = 51377;
-                constexpr std::uint64_t SKIP_FUNC = 51352;
-                constexpr std::size_t CAVE_START = 0x14B;
-                constexpr std::size_t CAVE_END = 0x2A0;
-                constexpr std::size_t JUMP_OUT = 0x2A0;
-                const auto fnAddr = reinterpret_cast<std::uintptr_t>(
-                    SkipSubMenuMenuPrompt<RE::CraftingSubMenus::AlchemyMenu, SKIP_FUNC>);
-                InstallSubMenuPatch<CALL_FUNC, CAVE_START, CAVE_END, JUMP_OUT>(fnAddr);
-			}
-            
-            logger::debug("Installed alchemy menu patch"sv);
-        }
-
-        if (*Settings::SmithingMenu) {
-            if (isSE) {
-                constexpr std::uint64_t CALL_FUNC = 50451;
-                constexpr std::uint64_t SKIP_FUNC = 50477;
-                constexpr std::size_t CAVE_START = 0x7C;
-                constexpr std::size_t CAVE_END = 0x191;
-                constexpr std::size_t JUMP_OUT = 0x1E5;
-                const auto fnAddr = reinterpret_cast<std::uintptr_t>(
-                    SkipSubMenuMenuPrompt<RE::CraftingSubMenus::SmithingMenu, SKIP_FUNC>);
-                InstallSubMenuPatch<CALL_FUNC, CAVE_START, CAVE_END, JUMP_OUT>(fnAddr);
-			} else {
-                constexpr std::uint64_t CALL_FUNC = 51356;
-                constexpr std::uint64_t SKIP_FUNC = 51370;
-                constexpr std::size_t CAVE_START = 0x7D;
-                constexpr std::size_t CAVE_END = 0x191;
-                constexpr std::size_t JUMP_OUT = 0x1E4;
-                const auto fnAddr = reinterpret_cast<std::uintptr_t>(
-                    SkipSubMenuMenuPrompt<RE::CraftingSubMenus::SmithingMenu, SKIP_FUNC>);
-                InstallSubMenuPatch<CALL_FUNC, CAVE_START, CAVE_END, JUMP_OUT>(fnAddr);
-			}
-            
-            logger::debug("Installed smithing menu patch"sv);
-        }
-
-        if (*Settings::EnchantmentLearned) {
-            InstallEnchantmentLearnedPatch(isSE);
+    void Sync() {
+        Patches::PatchTransaction installs;
+        std::array<std::pair<std::size_t, std::size_t>, std::to_underlying(Patches::Patch::kTotal)> queued{};
+
+        for (std::size_t i = 0; i < patchStates.size(); ++i) {
+            const auto patch = static_cast<Patches::Patch>(i);
+            auto& state = patchStates[i];
+            const bool enabled = IsEnabled(patch) && (state.installed || IsDue(patch));
+            if (enabled == state.installed) {
+                continue;
+            }
+
+            if (!enabled) {
+                Uninstall(patch);
+                continue;
+            }
+
+            const auto first = installs.edits().size();
+            Profiler::ScopedTimer timer{"patch"sv, Patches::GetPatchName(patch)};
+            if (QueuePatch(patch, installs)) {
+                queued[i] = {first, installs.edits().size()};
+            } else {
+                logger::error("Skipped {} patch"sv, Patches::GetPatchName(patch));
+            }
+        }
+
+        // the time QueuePatch spent in this Sync, so each caller's profile shows only its own share
+        if (resolveTime != Profiler::duration::zero() || codegenTime != Profiler::duration::zero()) {
+            Profiler::Record("address resolution"sv, std::exchange(resolveTime, {}));
+            Profiler::Record("code generation"sv, std::exchange(codegenTime, {}));
         }
 
+        if (installs.empty()) {
+            return;
+        }
+
+        bool committed = false;
         {
+            Profiler::ScopedTimer timer{"commit"sv};
+            committed = installs.Commit();
+        }
 
-            if (*Settings::EnchantmentCrafted) {
-                if (isSE) {
-                    constexpr std::uint64_t CALL_FUNC = 50487;
-                    constexpr std::uint64_t SKIP_FUNC = 50450;
-                    constexpr std::size_t CAVE_START = 0x160;
-                    constexpr std::size_t CAVE_END = 0x1FD;
-                    constexpr std::size_t JUMP_OUT = 0x260;
-                    const auto fnAddr = reinterpret_cast<std::uintptr_t>(
-                        SkipSubMenuMenuPrompt<RE::CraftingSubMenus::EnchantConstructMenu, SKIP_FUNC>);
-                    InstallSubMenuPatch<CALL_FUNC, CAVE_START, CAVE_END, JUMP_OUT>(fnAddr);
-				} else {
-                    constexpr std::uint64_t CALL_FUNC = 51379;
-                    constexpr std::uint64_t SKIP_FUNC = 51355;
-                    constexpr std::size_t CAVE_START = 0x185;
-                    constexpr std::size_t CAVE_END = 0x23F;
-                    constexpr std::size_t JUMP_OUT = 0x2C2;
-                    const auto fnAddr = reinterpret_cast<std::uintptr_t>(
-                        SkipSubMenuMenuPrompt<RE::CraftingSubMenus::EnchantConstructMenu, SKIP_FUNC>);
-                    InstallSubMenuPatch<CALL_FUNC, CAVE_START, CAVE_END, JUMP_OUT>(fnAddr);
-				}
-
-                logger::debug("Installed enchantment crafted patch"sv);
-            }
-
-            if (*Settings::EnchantingMenuExit) {
-                if (isSE) {
-                    constexpr std::uint64_t CALL_FUNC = 50487;
-                    constexpr std::size_t CAVE_START = 0x74;
-                    constexpr std::size_t CAVE_END = 0x111;
-                    constexpr std::size_t JUMP_OUT = 0x111;
-                    const auto fnAddr = reinterpret_cast<std::uintptr_t>(CloseEnchantingMenu);
-                    InstallSubMenuPatch<CALL_FUNC, CAVE_START, CAVE_END, JUMP_OUT>(fnAddr);
-				} else {
-                    constexpr std::uint64_t CALL_FUNC = 51379;
-                    constexpr std::size_t CAVE_START = 0x6F;
-                    constexpr std::size_t CAVE_END = 0x129;
-                    constexpr std::size_t JUMP_OUT = 0x129;
-                    const auto fnAddr = reinterpret_cast<std::uintptr_t>(CloseEnchantingMenu);
-                    InstallSubMenuPatch<CALL_FUNC, CAVE_START, CAVE_END, JUMP_OUT>(fnAddr);
-				}
-
-                logger::debug("Installed enchanting menu exit patch"sv);
-            }
-        }
-
-        if (*Settings::Poison) {
-            InstallPoisonPatch();
+        if (!committed) {
+            logger::error("Failed to unprotect code pages, no patches were installed"sv);
+            return;
         }
 
+        const auto& edits = installs.edits();
+        for (std::size_t i = 0; i < patchStates.size(); ++i) {
+            const auto [first, last] = queued[i];
+            if (first == last) {
+                continue;
+            }
+
+            auto& state = patchStates[i];
+            state.edits.assign(edits.begin() + first, edits.begin() + last);
+            state.installed = true;
+            logger::debug("Installed {} patch"sv, Patches::GetPatchName(static_cast<Patches::Patch>(i)));
+        }
+    }
+
+    void Install() {
+        Menus::AddOpenListener(OnMenuOpen);
+        Menus::AddFrameListener(Menus::Menu::kHUD, FlushLearnedNotifications);
+        Menus::AddFrameListener(Menus::Menu::kCrafting, RunBatchStep);
+        Sync();
+
         logger::debug("Installed hooks"sv);
     }
 }  // namespace Hooks
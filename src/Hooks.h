@@ -2,4 +2,8 @@
 
 namespace Hooks {
     void Install();
+
+    // Installs and uninstalls patches until they match the current settings. Call from the main thread only, so no
+    // menu code is running while the caves are rewritten.
+    void Sync();
 }
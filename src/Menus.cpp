@@ -0,0 +1,88 @@
+#include "Menus.h"
+
+namespace Menus {
+    namespace {
+        // Holding a reference keeps a menu alive until its close event, so the cached pointers never dangle.
+        RE::GPtr<RE::CraftingMenu> craftingMenu;
+        RE::GPtr<RE::InventoryMenu> inventoryMenu;
+
+        std::vector<std::function<void(Menu)>> openListeners;
+        std::array<std::vector<std::function<void()>>, 3> frameListeners;
+
+        template <Menu MENU>
+        struct AdvanceMovie {
+            static void thunk(RE::IMenu* a_menu, float a_interval, std::uint32_t a_currentTime) {
+                func(a_menu, a_interval, a_currentTime);
+                for (const auto& listener : frameListeners[std::to_underlying(MENU)]) {
+                    listener();
+                }
+            }
+
+            static inline REL::Relocation<decltype(thunk)> func;
+            static constexpr std::size_t idx = 0x5;
+        };
+
+        template <Menu MENU>
+        void WriteFrameHook(REL::Relocation<std::uintptr_t> a_vtbl) {
+            AdvanceMovie<MENU>::func = a_vtbl.write_vfunc(AdvanceMovie<MENU>::idx, AdvanceMovie<MENU>::thunk);
+        }
+
+        class EventHandler : public RE::BSTEventSink<RE::MenuOpenCloseEvent> {
+        public:
+            [[nodiscard]] static EventHandler* GetSingleton() {
+                static EventHandler singleton;
+                return std::addressof(singleton);
+            }
+
+            RE::BSEventNotifyControl ProcessEvent(const RE::MenuOpenCloseEvent* a_event,
+                                                  RE::BSTEventSource<RE::MenuOpenCloseEvent>*) override {
+                if (!a_event) {
+                    return RE::BSEventNotifyControl::kContinue;
+                }
+
+                if (a_event->menuName == RE::CraftingMenu::MENU_NAME) {
+                    Update(craftingMenu, Menu::kCrafting, a_event->opening);
+                } else if (a_event->menuName == RE::InventoryMenu::MENU_NAME) {
+                    Update(inventoryMenu, Menu::kInventory, a_event->opening);
+                }
+
+                return RE::BSEventNotifyControl::kContinue;
+            }
+
+        private:
+            template <class T>
+            static void Update(RE::GPtr<T>& a_menu, Menu a_type, bool a_opening) {
+                if (!a_opening) {
+                    a_menu.reset();
+                    return;
+                }
+
+                a_menu = RE::UI::GetSingleton()->GetMenu<T>();
+                for (const auto& listener : openListeners) {
+                    listener(a_type);
+                }
+            }
+        };
+    }  // namespace
+
+    void Register() {
+        RE::UI::GetSingleton()->AddEventSink<RE::MenuOpenCloseEvent>(EventHandler::GetSingleton());
+        WriteFrameHook<Menu::kHUD>(REL::Relocation<std::uintptr_t>{RE::VTABLE_HUDMenu[0]});
+        WriteFrameHook<Menu::kCrafting>(REL::Relocation<std::uintptr_t>{RE::VTABLE_CraftingMenu[0]});
+        logger::debug("Registered menu event handler"sv);
+    }
+
+    void AddOpenListener(std::function<void(Menu)> a_listener) { openListeners.push_back(std::move(a_listener)); }
+
+    void AddFrameListener(Menu a_menu, std::function<void()> a_listener) {
+        frameListeners[std::to_underlying(a_menu)].push_back(std::move(a_listener));
+    }
+
+    RE::CraftingMenu* GetCraftingMenu() noexcept { return craftingMenu.get(); }
+
+    RE::CraftingSubMenus::CraftingSubMenu* GetCraftingSubMenu() noexcept {
+        return craftingMenu ? craftingMenu->GetCraftingSubMenu() : nullptr;
+    }
+
+    RE::InventoryMenu* GetInventoryMenu() noexcept { return inventoryMenu.get(); }
+}  // namespace Menus
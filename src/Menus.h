@@ -0,0 +1,23 @@
+#pragma once
+
+// Typed pointers to the menus the callbacks work on, kept up to date by menu open/close events so the callbacks never
+// have to look a menu up by name. Events and callbacks both run on the main thread.
+namespace Menus {
+    enum class Menu { kCrafting, kInventory, kHUD };
+
+    // Starts listening for menu events and hooks the per-frame update of the HUD and crafting menus. Needs the UI, so
+    // call it once data has loaded.
+    void Register();
+
+    // Calls a_listener every time the crafting or inventory menu opens, once its pointer is cached.
+    void AddOpenListener(std::function<void(Menu)> a_listener);
+
+    // Calls a_listener once per frame while a_menu is open, right after the menu advanced its movie. Only the HUD and
+    // crafting menus are hooked.
+    void AddFrameListener(Menu a_menu, std::function<void()> a_listener);
+
+    // Each of these returns nullptr while the menu is closed.
+    [[nodiscard]] RE::CraftingMenu* GetCraftingMenu() noexcept;
+    [[nodiscard]] RE::CraftingSubMenus::CraftingSubMenu* GetCraftingSubMenu() noexcept;
+    [[nodiscard]] RE::InventoryMenu* GetInventoryMenu() noexcept;
+}
@@ -0,0 +1,93 @@
+#include "MessageBoxes.h"
+
+#include "Settings.h"
+
+namespace MessageBoxes {
+    namespace {
+        // lets the table be searched with the string_view of a message box without copying it
+        struct StringHash {
+            using is_transparent = void;
+
+            [[nodiscard]] std::size_t operator()(std::string_view a_str) const noexcept {
+                return std::hash<std::string_view>{}(a_str);
+            }
+        };
+
+        using AnswerMap = std::unordered_map<std::string, std::int64_t, StringHash, std::equal_to<>>;
+
+        // message text to the index of the button that answers it, built on first use
+        [[nodiscard]] AnswerMap& GetAnswers() {
+            static AnswerMap answers;
+            return answers;
+        }
+
+        // Callbacks see the pressed button offset by the menu's internal messages.
+        constexpr std::int64_t BUTTON_MESSAGE_OFFSET = 4;
+
+        [[nodiscard]] std::string GetText(const std::string& a_key) {
+            const auto gameSettings = RE::GameSettingCollection::GetSingleton();
+            const auto setting = gameSettings ? gameSettings->GetSetting(a_key.c_str()) : nullptr;
+            if (setting && setting->GetType() == RE::Setting::Type::kString) {
+                const auto text = setting->GetString();
+                return text ? text : "";
+            }
+            return a_key;
+        }
+
+        // Presses the configured button of a_data if there is one. Returns false to show the box as usual.
+        [[nodiscard]] bool Answer(RE::MessageBoxData* a_data) {
+            const auto& answers = GetAnswers();
+            if (!a_data || !a_data->callback || answers.empty()) {
+                return false;
+            }
+
+            const auto it = answers.find(std::string_view{a_data->bodyText.c_str()});
+            if (it == answers.end()) {
+                return false;
+            }
+
+            const auto button = it->second;
+            if (button < 0 || static_cast<std::size_t>(button) >= a_data->buttonText.size()) {
+                logger::warn("Message box \"{}\" has no button {}"sv, it->first, button);
+                return false;
+            }
+
+            using Message = RE::IMessageBoxCallback::Message;
+            a_data->callback->Run(static_cast<Message>(button + BUTTON_MESSAGE_OFFSET));
+            logger::debug("Answered message box \"{}\" with button {}"sv, it->first, button);
+            return true;
+        }
+
+        struct ProcessMessage {
+            static RE::UI_MESSAGE_RESULTS thunk(RE::MessageBoxMenu* a_menu, RE::UIMessage& a_message) {
+                if (a_message.type == RE::UI_MESSAGE_TYPE::kShow &&
+                    Answer(static_cast<RE::MessageBoxData*>(a_message.data))) {
+                    // the menu is already on the stack, close it before it draws anything
+                    RE::UIMessageQueue::GetSingleton()->AddMessage(RE::MessageBoxMenu::MENU_NAME,
+                                                                   RE::UI_MESSAGE_TYPE::kHide, nullptr);
+                    return RE::UI_MESSAGE_RESULTS::kHandled;
+                }
+                return func(a_menu, a_message);
+            }
+
+            static inline REL::Relocation<decltype(thunk)> func;
+            static constexpr std::size_t idx = 0x4;
+        };
+    }  // namespace
+
+    void Install() {
+        REL::Relocation<std::uintptr_t> vtbl{RE::VTABLE_MessageBoxMenu[0]};
+        ProcessMessage::func = vtbl.write_vfunc(ProcessMessage::idx, ProcessMessage::thunk);
+        Rebuild();
+        logger::debug("Installed message box hook"sv);
+    }
+
+    void Rebuild() {
+        auto& answers = GetAnswers();
+        answers.clear();
+        for (const auto& [key, button] : Settings::MessageBoxAnswers()) {
+            answers.insert_or_assign(GetText(key), button);
+        }
+        logger::debug("Loaded {} message box answers"sv, answers.size());
+    }
+}  // namespace MessageBoxes
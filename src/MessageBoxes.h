@@ -0,0 +1,11 @@
+#pragma once
+
+// Answers message boxes listed in [MessageBoxes] without showing them. A single hook on the message box menu looks the
+// box's text up in a hash table, so new prompts only need a line in YesImSure.toml instead of a code cave per runtime.
+namespace MessageBoxes {
+    void Install();
+
+    // Rebuilds the lookup table from the settings. Game setting names resolve to their current text, so call it again
+    // once data has loaded and after the settings are reloaded.
+    void Rebuild();
+}
@@ -0,0 +1,45 @@
+#include "Notifications.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace Notifications {
+    using namespace std::literals;
+
+    std::size_t Coalescer::Append(std::array<char, BUFFER_SIZE>& a_buffer, std::size_t a_size,
+                                  std::string_view a_str) noexcept {
+        // always leave room for the terminator
+        const auto len = std::min(a_str.size(), a_buffer.size() - 1 - a_size);
+        std::copy_n(a_str.data(), len, a_buffer.data() + a_size);
+        a_size += len;
+        a_buffer[a_size] = '\0';
+        return a_size;
+    }
+
+    void Coalescer::Push(std::string_view a_format, std::string_view a_name, time_point a_now) noexcept {
+        if (_count == 0) {
+            (void)Append(_format, 0, a_format);
+            _namesSize = Append(_names, 0, a_name);
+            _due = std::max(a_now + _window, _lastShown + _interval);
+        } else {
+            _namesSize = Append(_names, _namesSize, ", "sv);
+            _namesSize = Append(_names, _namesSize, a_name);
+        }
+
+        ++_count;
+    }
+
+    std::string_view Coalescer::Poll(time_point a_now) noexcept {
+        if (_count == 0 || a_now < _due) {
+            return {};
+        }
+
+        // the names are null terminated by Append, the format comes from the game
+        const auto len = std::snprintf(_out.data(), _out.size(), _format.data(), _names.data());
+        const auto size = std::min(static_cast<std::size_t>(std::max(len, 0)), _out.size() - 1);
+
+        _count = 0;
+        _lastShown = a_now;
+        return {_out.data(), size};
+    }
+}  // namespace Notifications
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string_view>
+
+// Game independent core of the learned enchantment notifications. Messages that arrive within a short window are
+// merged into one, and merged messages are handed out no faster than a fixed interval so the HUD queue never backs up.
+// Everything is formatted into fixed buffers, nothing allocates. Not thread safe, the game only notifies from the main
+// thread.
+namespace Notifications {
+    class Coalescer {
+    public:
+        using clock_type = std::chrono::steady_clock;
+        using duration = clock_type::duration;
+        using time_point = clock_type::time_point;
+
+        static constexpr std::size_t BUFFER_SIZE = 512;
+
+        Coalescer(duration a_window, duration a_interval) noexcept : _window(a_window), _interval(a_interval) {}
+
+        // Takes effect with the next message that starts a new window.
+        void SetTiming(duration a_window, duration a_interval) noexcept {
+            _window = a_window;
+            _interval = a_interval;
+        }
+
+        // a_format is the game's localized printf format with a single %s. A message on its own is formatted with
+        // a_name, merged messages with the comma separated names, using the format of the first one.
+        void Push(std::string_view a_format, std::string_view a_name, time_point a_now) noexcept;
+
+        [[nodiscard]] bool pending() const noexcept { return _count != 0; }
+
+        // Returns the next message once it is due, otherwise an empty view. The view is null terminated and stays
+        // valid until the next call to Poll.
+        [[nodiscard]] std::string_view Poll(time_point a_now) noexcept;
+
+    private:
+        static std::size_t Append(std::array<char, BUFFER_SIZE>& a_buffer, std::size_t a_size,
+                                  std::string_view a_str) noexcept;
+
+        duration _window;
+        duration _interval;
+        time_point _due{};
+        time_point _lastShown{};
+        std::size_t _count{0};
+        std::array<char, BUFFER_SIZE> _format{};
+        std::array<char, BUFFER_SIZE> _names{};
+        std::size_t _namesSize{0};
+        std::array<char, BUFFER_SIZE> _out{};
+    };
+}  // namespace Notifications
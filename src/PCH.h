@@ -2,22 +2,28 @@
 
 #include <cassert>
 #include <exception>
+#include <filesystem>
+#include <functional>
+#include <ranges>
 #include <span>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 #pragma warning(push)
 #include <RE/Skyrim.h>
 #include <REL/Relocation.h>
 #include <SKSE/SKSE.h>
-#include <xbyak/xbyak.h>
 
 #include <ShlObj_core.h>
 #include <Windows.h>
 #include <Psapi.h>
 #undef cdecl // Workaround for Clang 14 CMake configure error.
 
+#include <spdlog/async.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/msvc_sink.h>
 
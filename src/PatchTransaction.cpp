@@ -0,0 +1,143 @@
+#include "PatchTransaction.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace Patches {
+    namespace {
+#if defined(_WIN32)
+        class NativeBackend : public IMemoryBackend {
+        public:
+            [[nodiscard]] std::size_t PageSize() const noexcept override {
+                SYSTEM_INFO info;
+                GetSystemInfo(&info);
+                return info.dwPageSize;
+            }
+
+            [[nodiscard]] bool Unprotect(std::uintptr_t a_address, std::size_t a_size,
+                                         std::uint32_t& a_oldProtect) noexcept override {
+                DWORD old = 0;
+                const bool success =
+                    VirtualProtect(reinterpret_cast<void*>(a_address), a_size, PAGE_EXECUTE_READWRITE, &old) != 0;
+                a_oldProtect = old;
+                return success;
+            }
+
+            [[nodiscard]] bool Protect(std::uintptr_t a_address, std::size_t a_size,
+                                       std::uint32_t a_protect) noexcept override {
+                DWORD old = 0;
+                return VirtualProtect(reinterpret_cast<void*>(a_address), a_size, a_protect, &old) != 0;
+            }
+
+            void FlushInstructionCache(std::uintptr_t a_address, std::size_t a_size) noexcept override {
+                ::FlushInstructionCache(GetCurrentProcess(), reinterpret_cast<void*>(a_address), a_size);
+            }
+        };
+#else
+        // mprotect cannot report the previous protection, code pages are assumed to be read/execute.
+        class NativeBackend : public IMemoryBackend {
+        public:
+            [[nodiscard]] std::size_t PageSize() const noexcept override {
+                return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+            }
+
+            [[nodiscard]] bool Unprotect(std::uintptr_t a_address, std::size_t a_size,
+                                         std::uint32_t& a_oldProtect) noexcept override {
+                a_oldProtect = PROT_READ | PROT_EXEC;
+                return mprotect(reinterpret_cast<void*>(a_address), a_size, PROT_READ | PROT_WRITE | PROT_EXEC) == 0;
+            }
+
+            [[nodiscard]] bool Protect(std::uintptr_t a_address, std::size_t a_size,
+                                       std::uint32_t a_protect) noexcept override {
+                return mprotect(reinterpret_cast<void*>(a_address), a_size, static_cast<int>(a_protect)) == 0;
+            }
+
+            void FlushInstructionCache(std::uintptr_t a_address, std::size_t a_size) noexcept override {
+                const auto begin = reinterpret_cast<char*>(a_address);
+                __builtin___clear_cache(begin, begin + a_size);
+            }
+        };
+#endif
+    }  // namespace
+
+    IMemoryBackend& GetNativeBackend() noexcept {
+        static NativeBackend backend;
+        return backend;
+    }
+
+    void PatchTransaction::Fill(std::uintptr_t a_address, std::uint8_t a_value, std::size_t a_count) {
+        _edits.push_back({a_address, std::vector<std::byte>(a_count, static_cast<std::byte>(a_value)), {}});
+    }
+
+    void PatchTransaction::Write(std::uintptr_t a_address, std::span<const std::byte> a_bytes) {
+        _edits.push_back({a_address, {a_bytes.begin(), a_bytes.end()}, {}});
+    }
+
+    std::vector<PatchTransaction::PageRun> PatchTransaction::GetPageRuns() const {
+        const auto pageSize = _backend.PageSize();
+
+        std::vector<std::pair<std::uintptr_t, std::uintptr_t>> ranges;
+        ranges.reserve(_edits.size());
+        for (const auto& edit : _edits) {
+            if (edit.bytes.empty()) {
+                continue;
+            }
+            const auto first = edit.address / pageSize * pageSize;
+            const auto last = (edit.address + edit.bytes.size() + pageSize - 1) / pageSize * pageSize;
+            ranges.emplace_back(first, last);
+        }
+
+        std::ranges::sort(ranges);
+
+        std::vector<PageRun> runs;
+        for (const auto& [first, last] : ranges) {
+            if (!runs.empty() && first <= runs.back().address + runs.back().size) {
+                auto& run = runs.back();
+                run.size = std::max(run.size, last - run.address);
+            } else {
+                runs.push_back({first, last - first, 0});
+            }
+        }
+
+        return runs;
+    }
+
+    bool PatchTransaction::Commit() {
+        auto runs = GetPageRuns();
+
+        // every page is made writable before the first byte is written, so a failure leaves the code untouched
+        std::size_t unprotected = 0;
+        for (; unprotected < runs.size(); ++unprotected) {
+            auto& run = runs[unprotected];
+            if (!_backend.Unprotect(run.address, run.size, run.oldProtect)) {
+                break;
+            }
+        }
+
+        const bool success = unprotected == runs.size();
+        if (success) {
+            for (auto& edit : _edits) {
+                const auto dst = reinterpret_cast<std::byte*>(edit.address);
+                edit.original.assign(dst, dst + edit.bytes.size());
+                std::memcpy(dst, edit.bytes.data(), edit.bytes.size());
+            }
+        }
+
+        for (std::size_t i = 0; i < unprotected; ++i) {
+            const auto& run = runs[i];
+            (void)_backend.Protect(run.address, run.size, run.oldProtect);
+            if (success) {
+                _backend.FlushInstructionCache(run.address, run.size);
+            }
+        }
+
+        return success;
+    }
+}  // namespace Patches
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Patches {
+    // The few memory protection primitives a transaction needs, so the grouping logic does not care which OS it runs
+    // on.
+    class IMemoryBackend {
+    public:
+        virtual ~IMemoryBackend() = default;
+
+        [[nodiscard]] virtual std::size_t PageSize() const noexcept = 0;
+
+        // Makes [a_address, a_address + a_size) writable and stores the previous protection in a_oldProtect.
+        [[nodiscard]] virtual bool Unprotect(std::uintptr_t a_address, std::size_t a_size,
+                                             std::uint32_t& a_oldProtect) noexcept = 0;
+
+        [[nodiscard]] virtual bool Protect(std::uintptr_t a_address, std::size_t a_size,
+                                           std::uint32_t a_protect) noexcept = 0;
+
+        virtual void FlushInstructionCache(std::uintptr_t a_address, std::size_t a_size) noexcept = 0;
+    };
+
+    // VirtualProtect on Windows, mprotect elsewhere.
+    [[nodiscard]] IMemoryBackend& GetNativeBackend() noexcept;
+
+    // Collects fills and writes and commits them with one protection change per run of contiguous pages. Edits are
+    // applied in the order they were added, so a fill followed by a write over the same range behaves like the
+    // separate REL::safe_fill/REL::safe_write calls it replaces.
+    class PatchTransaction {
+    public:
+        struct Edit {
+            std::uintptr_t address;
+            std::vector<std::byte> bytes;
+            std::vector<std::byte> original;  // captured by Commit
+        };
+
+        explicit PatchTransaction(IMemoryBackend& a_backend = GetNativeBackend()) noexcept : _backend(a_backend) {}
+
+        void Fill(std::uintptr_t a_address, std::uint8_t a_value, std::size_t a_count);
+        void Write(std::uintptr_t a_address, std::span<const std::byte> a_bytes);
+
+        // Applies every edit or none of them. On failure anything already written is restored.
+        [[nodiscard]] bool Commit();
+
+        [[nodiscard]] const std::vector<Edit>& edits() const noexcept { return _edits; }
+        [[nodiscard]] bool empty() const noexcept { return _edits.empty(); }
+
+    private:
+        struct PageRun {
+            std::uintptr_t address;
+            std::size_t size;
+            std::uint32_t oldProtect;
+        };
+
+        [[nodiscard]] std::vector<PageRun> GetPageRuns() const;
+
+        IMemoryBackend& _backend;
+        std::vector<Edit> _edits;
+    };
+}  // namespace Patches
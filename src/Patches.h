@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "Signature.h"
+#include "Thunks.h"
+
+// Platform neutral description of every code cave this plugin writes. Nothing in here may depend on the game headers,
+// so the table can be inspected off the game as well.
+namespace Patches {
+    using namespace std::literals;
+
+    enum class Runtime : std::uint8_t { kSE, kAE };
+
+    // One entry per [Patches] toggle in YesImSure.toml.
+    enum class Patch : std::uint8_t {
+        kConstructibleObjectMenu,
+        kAlchemyMenu,
+        kSmithingMenu,
+        kEnchantmentLearned,
+        kEnchantmentCrafted,
+        kEnchantingMenuExit,
+        kPoison,
+
+        kTotal
+    };
+
+    // What the thunk written into a cave ends up calling.
+    enum class Callback : std::uint8_t {
+        kNone,
+        kConstructibleObjectMenu,
+        kAlchemyMenu,
+        kSmithingMenu,
+        kEnchantmentLearned,
+        kEnchantmentCrafted,
+        kCloseEnchantingMenu,
+        kRefreshInventoryMenu,
+        kNotifyEnchantmentLearned,
+        kDebugNotification,
+        kGetEquippedEntryData,
+        kBeginPoisonApplication,
+
+        kTotal
+    };
+
+    [[nodiscard]] constexpr std::string_view GetPatchName(Patch a_patch) noexcept {
+        switch (a_patch) {
+            case Patch::kConstructibleObjectMenu:
+                return "constructible object menu"sv;
+            case Patch::kAlchemyMenu:
+                return "alchemy menu"sv;
+            case Patch::kSmithingMenu:
+                return "smithing menu"sv;
+            case Patch::kEnchantmentLearned:
+                return "enchantment learned"sv;
+            case Patch::kEnchantmentCrafted:
+                return "enchantment crafted"sv;
+            case Patch::kEnchantingMenuExit:
+                return "enchanting menu exit"sv;
+            case Patch::kPoison:
+                return "poison"sv;
+            default:
+                return "unknown"sv;
+        }
+    }
+
+    [[nodiscard]] constexpr std::string_view GetCallbackName(Callback a_callback) noexcept {
+        switch (a_callback) {
+            case Callback::kConstructibleObjectMenu:
+                return "SkipSubMenuMenuPrompt<ConstructibleObjectMenu>"sv;
+            case Callback::kAlchemyMenu:
+                return "SkipSubMenuMenuPrompt<AlchemyMenu>"sv;
+            case Callback::kSmithingMenu:
+                return "SkipSubMenuMenuPrompt<SmithingMenu>"sv;
+            case Callback::kEnchantmentLearned:
+                return "SkipSubMenuMenuPrompt<EnchantmentLearned>"sv;
+            case Callback::kEnchantmentCrafted:
+                return "SkipSubMenuMenuPrompt<EnchantmentCrafted>"sv;
+            case Callback::kCloseEnchantingMenu:
+                return "CloseEnchantingMenu"sv;
+            case Callback::kRefreshInventoryMenu:
+                return "RefreshInventoryMenu"sv;
+            case Callback::kNotifyEnchantmentLearned:
+                return "NotifyEnchantmentLearned"sv;
+            case Callback::kDebugNotification:
+                return "DebugNotification"sv;
+            case Callback::kGetEquippedEntryData:
+                return "GetEquippedEntryData"sv;
+            case Callback::kBeginPoisonApplication:
+                return "BeginPoisonApplication"sv;
+            default:
+                return "unknown"sv;
+        }
+    }
+
+    struct Cave {
+        [[nodiscard]] constexpr std::size_t size() const noexcept { return end - start; }
+
+        Patch patch;
+        std::uint64_t funcID;  // function the cave lives in
+        std::size_t start;
+        std::size_t end;
+        std::size_t jumpOut;  // offset from funcID the thunk returns to
+        Thunk thunk;
+        Callback callback;
+        std::uint64_t callbackID;  // engine function the callback needs, 0 if none
+    };
+
+    // A 5 byte call redirected to a callback through the trampoline.
+    struct CallSite {
+        Patch patch;
+        std::uint64_t funcID;
+        std::size_t offset;
+        Callback callback;
+        std::string_view signature{"E8 ?? ?? ?? ??"sv};  // the call being rewritten
+    };
+
+    namespace detail {
+        using enum Patch;
+        using enum Thunk;
+        using C = Callback;
+
+        inline constexpr std::array SE_CAVES{
+            Cave{kConstructibleObjectMenu, 50452, 0x5F, 0x174, 0x192, kCall, C::kConstructibleObjectMenu, 50476},
+            Cave{kAlchemyMenu, 50485, 0x138, 0x2A9, 0x2AB, kCall, C::kAlchemyMenu, 50447},
+            Cave{kSmithingMenu, 50451, 0x7C, 0x191, 0x1E5, kCall, C::kSmithingMenu, 50477},
+            // skip "are you sure?"
+            Cave{kEnchantmentLearned, 50440, 0xBB, 0x1D3, 0x38D, kCall, C::kEnchantmentLearned, 50459},
+            // nop until format string gets loaded
+            Cave{kEnchantmentLearned, 50459, 0x15D, 0x1A7, 0, kNone, C::kNone, 0},
+            // swap messagebox for debug notification
+            Cave{kEnchantmentLearned, 50459, 0x1AE, 0x1EB, 0x1EB, kEnchantNotify, C::kNotifyEnchantmentLearned, 0},
+            Cave{kEnchantmentCrafted, 50487, 0x160, 0x1FD, 0x260, kCall, C::kEnchantmentCrafted, 50450},
+            Cave{kEnchantingMenuExit, 50487, 0x74, 0x111, 0x111, kCall, C::kCloseEnchantingMenu, 0},
+            // nop until callback gets loaded
+            Cave{kPoison, 39406, 0xA3, 0xD7, 0, kNone, C::kNone, 0},
+            // hook callback
+            Cave{kPoison, 39406, 0xDE, 0x112, 0x148, kPoisonCallback, C::kRefreshInventoryMenu, 0},
+            // swap messagebox error for debug notification
+            Cave{kPoison, 39406, 0x119, 0x148, 0x148, kPoisonNotify, C::kDebugNotification, 52933},
+        };
+
+        inline constexpr std::array AE_CAVES{
+            Cave{kConstructibleObjectMenu, 51357, 0x5A, 0x169, 0x187, kCall, C::kConstructibleObjectMenu, 51369},
+            Cave{kAlchemyMenu, 51377, 0x14B, 0x2A0, 0x2A0, kCall, C::kAlchemyMenu, 51352},
+            Cave{kSmithingMenu, 51356, 0x7D, 0x191, 0x1E4, kCall, C::kSmithingMenu, 51370},
+            Cave{kEnchantmentLearned, 51344, 0xC2, 0x1D7, 0x4DF, kCall, C::kEnchantmentLearned, 51363},
+            Cave{kEnchantmentLearned, 51363, 0x15D, 0x1A7, 0, kNone, C::kNone, 0},
+            Cave{kEnchantmentLearned, 51363, 0x1AE, 0x1EB, 0x1EB, kEnchantNotify, C::kNotifyEnchantmentLearned, 0},
+            Cave{kEnchantmentCrafted, 51379, 0x185, 0x23F, 0x2C2, kCall, C::kEnchantmentCrafted, 51355},
+            Cave{kEnchantingMenuExit, 51379, 0x6F, 0x129, 0x129, kCall, C::kCloseEnchantingMenu, 0},
+            Cave{kPoison, 40481, 0xA3, 0xD7, 0, kNone, C::kNone, 0},
+            Cave{kPoison, 40481, 0xDE, 0x112, 0x148, kPoisonCallback, C::kRefreshInventoryMenu, 0},
+            Cave{kPoison, 40481, 0x119, 0x148, 0x148, kPoisonNotify, C::kDebugNotification, 52933},
+        };
+
+        // Fix for applying poison to left hand. The first call of the application also starts it.
+        inline constexpr std::array SE_CALL_SITES{
+            CallSite{kPoison, 39406, 0x2F, C::kBeginPoisonApplication},
+            CallSite{kPoison, 39407, 0x32, C::kGetEquippedEntryData},
+        };
+
+        inline constexpr std::array AE_CALL_SITES{
+            CallSite{kPoison, 40481, 0x2F, C::kBeginPoisonApplication},
+            CallSite{kPoison, 40482, 0x32, C::kGetEquippedEntryData},
+        };
+
+        template <std::size_t N>
+        [[nodiscard]] consteval bool IsValid(const std::array<Cave, N>& a_caves) {
+            return std::ranges::all_of(a_caves, [](const Cave& a_cave) {
+                return a_cave.start < a_cave.end && GetThunkSize(a_cave.thunk) <= a_cave.size() &&
+                       (a_cave.thunk == kNone || a_cave.jumpOut >= a_cave.end);
+            });
+        }
+
+        template <std::size_t N>
+        [[nodiscard]] consteval bool IsValid(const std::array<CallSite, N>& a_sites) {
+            return std::ranges::all_of(a_sites, [](const CallSite& a_site) {
+                return Signature::IsValid(a_site.signature) && Signature::Pattern(a_site.signature).size() == 5;
+            });
+        }
+
+        static_assert(IsValid(SE_CAVES), "a thunk does not fit its SE cave");
+        static_assert(IsValid(AE_CAVES), "a thunk does not fit its AE cave");
+        static_assert(IsValid(SE_CALL_SITES) && IsValid(AE_CALL_SITES));
+        static_assert(SE_CAVES.size() == AE_CAVES.size());
+    }  // namespace detail
+
+    [[nodiscard]] constexpr std::span<const Cave> GetCaves(Runtime a_runtime) noexcept {
+        return a_runtime == Runtime::kSE ? std::span<const Cave>{detail::SE_CAVES}
+                                         : std::span<const Cave>{detail::AE_CAVES};
+    }
+
+    [[nodiscard]] constexpr std::span<const CallSite> GetCallSites(Runtime a_runtime) noexcept {
+        return a_runtime == Runtime::kSE ? std::span<const CallSite>{detail::SE_CALL_SITES}
+                                         : std::span<const CallSite>{detail::AE_CALL_SITES};
+    }
+}  // namespace Patches
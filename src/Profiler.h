@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Load time breakdown. Samples go into a fixed buffer and are formatted once by Flush, so recording costs two clock
+// reads and a store. Only meant for the loading thread.
+namespace Profiler {
+    using clock_type = std::chrono::steady_clock;
+    using duration = clock_type::duration;
+
+    inline constexpr std::size_t MAX_SAMPLES = 64;
+
+    struct Sample {
+        std::string_view phase;
+        std::string_view detail;  // e.g. the patch name, may be empty
+        duration time;
+    };
+
+    namespace detail {
+        inline std::array<Sample, MAX_SAMPLES> samples{};
+        inline std::size_t size{0};
+        inline std::size_t dropped{0};
+    }  // namespace detail
+
+    // a_phase and a_detail must stay valid until Flush, string literals and the patch names are fine.
+    inline void Record(std::string_view a_phase, std::string_view a_detail, duration a_time) noexcept {
+        if (detail::size < detail::samples.size()) {
+            detail::samples[detail::size++] = {a_phase, a_detail, a_time};
+        } else {
+            ++detail::dropped;
+        }
+    }
+
+    inline void Record(std::string_view a_phase, duration a_time) noexcept { Record(a_phase, {}, a_time); }
+
+    // Records the lifetime of the timer as one sample.
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(std::string_view a_phase, std::string_view a_detail = {}) noexcept
+            : _phase(a_phase), _detail(a_detail) {}
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        ~ScopedTimer() { Record(_phase, _detail, clock_type::now() - _start); }
+
+    private:
+        std::string_view _phase;
+        std::string_view _detail;
+        clock_type::time_point _start{clock_type::now()};
+    };
+
+    // Adds the lifetime of the timer to a_total, for phases that are spread over a loop.
+    class AccumulatingTimer {
+    public:
+        explicit AccumulatingTimer(duration& a_total) noexcept : _total(a_total) {}
+
+        AccumulatingTimer(const AccumulatingTimer&) = delete;
+        AccumulatingTimer& operator=(const AccumulatingTimer&) = delete;
+
+        ~AccumulatingTimer() { _total += clock_type::now() - _start; }
+
+    private:
+        duration& _total;
+        clock_type::time_point _start{clock_type::now()};
+    };
+
+    // Formats every sample as a single JSON object and clears the buffer.
+    [[nodiscard]] inline std::string Flush() {
+        std::string json{R"({"unit":"us","phases":[)"};
+        for (std::size_t i = 0; i < detail::size; ++i) {
+            const auto& sample = detail::samples[i];
+            if (i != 0) {
+                json += ',';
+            }
+            json += R"({"phase":")";
+            json += sample.phase;
+            if (!sample.detail.empty()) {
+                json += R"(","detail":")";
+                json += sample.detail;
+            }
+            json += R"(","time":)";
+            json += std::to_string(std::chrono::duration<double, std::micro>(sample.time).count());
+            json += '}';
+        }
+        json += R"(],"dropped":)";
+        json += std::to_string(detail::dropped);
+        json += '}';
+
+        detail::size = 0;
+        detail::dropped = 0;
+        return json;
+    }
+}  // namespace Profiler
@@ -2,18 +2,93 @@
 
 #include "AutoTOML.hpp"
 
-#define MAKE_SETTING(a_type, a_group, a_key, a_value) \
-    inline a_type a_key { a_group##s, #a_key##s, a_value }
+// Every setting as X(type, group, key, default). Both the settings and SCHEMA are generated from this one list.
+#define YESIMSURE_SETTINGS(X)                                         \
+    X(bSetting, "General", HotReload, false)                          \
+    X(bSetting, "General", DeferInstall, false)                       \
+                                                                      \
+    X(bSetting, "Logging", AsyncLogging, false)                       \
+    X(bSetting, "Logging", BlockOnOverflow, false)                    \
+    X(iSetting, "Logging", LogLevel, 2)                               \
+    X(iSetting, "Logging", LogQueueSize, 8192)                        \
+    X(iSetting, "Logging", FlushInterval, 1)                          \
+                                                                      \
+    X(bSetting, "Patches", ConstructibleObjectMenu, true)             \
+    X(bSetting, "Patches", AlchemyMenu, true)                         \
+    X(bSetting, "Patches", SmithingMenu, true)                        \
+    X(bSetting, "Patches", EnchantmentLearned, false)                 \
+    X(bSetting, "Patches", EnchantmentCrafted, false)                 \
+    X(bSetting, "Patches", EnchantingMenuExit, true)                  \
+    X(bSetting, "Patches", Poison, true)                              \
+                                                                      \
+    X(bSetting, "BatchCrafting", BatchConstructibleObjectMenu, false) \
+    X(bSetting, "BatchCrafting", BatchAlchemyMenu, false)             \
+    X(bSetting, "BatchCrafting", BatchSmithingMenu, false)            \
+    X(bSetting, "BatchCrafting", BatchDisenchant, false)              \
+    X(iSetting, "BatchCrafting", BatchQuantity, 10)                   \
+    X(bSetting, "BatchCrafting", TemperAll, false)                    \
+                                                                      \
+    X(iSetting, "Poison", PoisonDoses, 1)                             \
+    X(bSetting, "Poison", PoisonBothHands, false)                     \
+                                                                      \
+    X(fSetting, "Notifications", CoalesceWindow, 0.5)                 \
+    X(fSetting, "Notifications", NotificationInterval, 1.0)
+
+#define MAKE_SETTING(a_type, a_group, a_key, a_value) inline constinit a_type a_key{a_value};
+#define MAKE_FIELD(a_type, a_group, a_key, a_value) AutoTOML::schema::Field{a_group##sv, #a_key##sv, a_key},
 
 namespace Settings {
-    using bSetting = AutoTOML::bSetting;
+    using bSetting = AutoTOML::schema::bSetting;
+    using fSetting = AutoTOML::schema::fSetting;
+    using iSetting = AutoTOML::schema::iSetting;
 
-    inline void Load() {
-        try {
-            const auto table = toml::parse_file("Data/SKSE/Plugins/YesImSure.toml"s);
-            for (const auto& setting : AutoTOML::ISetting::get_settings()) {
-                setting->load(table);
+    YESIMSURE_SETTINGS(MAKE_SETTING)
+
+    // every setting above, resolved in one pass by Parse
+    inline constexpr auto SCHEMA = AutoTOML::schema::make_schema(std::array{YESIMSURE_SETTINGS(MAKE_FIELD)});
+
+    // [MessageBoxes]: message text or game setting name of a prompt, mapped to the index of the button that answers it.
+    // Free form, so it is read next to the schema. Built on first use rather than during static initialization.
+    [[nodiscard]] inline std::unordered_map<std::string, std::int64_t>& MessageBoxAnswers() {
+        static std::unordered_map<std::string, std::int64_t> answers;
+        return answers;
+    }
+
+    inline constexpr auto PATH = "Data/SKSE/Plugins/YesImSure.toml"sv;
+
+    // Nothing is applied unless the whole file checks out, so a broken file never leaves the settings half loaded.
+    // Returns the warnings, missing settings keep their current value.
+    [[nodiscard]] inline std::string Parse() {
+        const auto table = toml::parse_file(PATH);
+        auto staged = AutoTOML::schema::stage(table, SCHEMA);
+        auto& errors = staged.report.errors;
+
+        std::unordered_map<std::string, std::int64_t> answers;
+        if (const auto group = table["MessageBoxes"sv].as_table()) {
+            for (const auto& [key, node] : *group) {
+                if (const auto button = node.as_integer()) {
+                    answers.emplace(key.str(), button->get());
+                } else {
+                    errors += errors.empty() ? "[MessageBoxes] "sv : "\n[MessageBoxes] "sv;
+                    errors += key.str();
+                    errors += ": value is not of expected type"sv;
+                }
             }
+        }
+
+        if (!errors.empty()) {
+            throw std::runtime_error(errors);
+        }
+
+        AutoTOML::schema::assign(staged, SCHEMA);
+        MessageBoxAnswers() = std::move(answers);
+        return std::move(staged.report.warnings);
+    }
+
+    // Runs before the logger exists, so the warnings are returned to be logged later.
+    [[nodiscard]] inline std::string Load() {
+        try {
+            return Parse();
         } catch (const toml::parse_error& e) {
             std::ostringstream ss;
             ss << "Error parsing file \'" << *e.source().path << "\':\n"
@@ -26,15 +101,25 @@ namespace Settings {
         } catch (...) {
             util::report_and_fail("unknown failure"sv);
         }
+        return {};
     }
 
-    MAKE_SETTING(bSetting, "Patches", ConstructibleObjectMenu, true);
-    MAKE_SETTING(bSetting, "Patches", AlchemyMenu, true);
-    MAKE_SETTING(bSetting, "Patches", SmithingMenu, true);
-    MAKE_SETTING(bSetting, "Patches", EnchantmentLearned, false);
-    MAKE_SETTING(bSetting, "Patches", EnchantmentCrafted, false);
-    MAKE_SETTING(bSetting, "Patches", EnchantingMenuExit, true);
-    MAKE_SETTING(bSetting, "Patches", Poison, true);
+    // Like Load, but a broken file while the game is running is logged instead of fatal.
+    [[nodiscard]] inline bool Reload() {
+        try {
+            if (const auto warnings = Parse(); !warnings.empty()) {
+                logger::warn("{}"sv, warnings);
+            }
+            return true;
+        } catch (const std::exception& e) {
+            logger::error("Failed to reload settings: {}"sv, e.what());
+        } catch (...) {
+            logger::error("Failed to reload settings"sv);
+        }
+        return false;
+    }
 }  // namespace Settings
 
+#undef MAKE_FIELD
 #undef MAKE_SETTING
+#undef YESIMSURE_SETTINGS
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+// Byte signatures in the usual "48 8B ?? ?? E8" notation. Platform neutral, so signatures can be checked against
+// images off the game as well.
+namespace Signature {
+    inline constexpr std::size_t MAX_SIZE = 64;
+
+    namespace detail {
+        [[nodiscard]] constexpr int HexValue(char a_ch) noexcept {
+            if (a_ch >= '0' && a_ch <= '9') {
+                return a_ch - '0';
+            } else if (a_ch >= 'A' && a_ch <= 'F') {
+                return a_ch - 'A' + 10;
+            } else if (a_ch >= 'a' && a_ch <= 'f') {
+                return a_ch - 'a' + 10;
+            } else {
+                return -1;
+            }
+        }
+
+        // Calls a_func(byte, isWildcard) for every token, returns false on malformed input.
+        template <class F>
+        constexpr bool Tokenize(std::string_view a_pattern, F a_func) {
+            std::size_t i = 0;
+            while (i < a_pattern.size()) {
+                if (a_pattern[i] == ' ') {
+                    ++i;
+                    continue;
+                }
+
+                if (i + 1 >= a_pattern.size()) {
+                    return false;
+                }
+
+                const auto hi = a_pattern[i];
+                const auto lo = a_pattern[i + 1];
+                if (hi == '?' && lo == '?') {
+                    a_func(std::byte{0}, true);
+                } else {
+                    const auto h = HexValue(hi);
+                    const auto l = HexValue(lo);
+                    if (h < 0 || l < 0) {
+                        return false;
+                    }
+                    a_func(static_cast<std::byte>((h << 4) | l), false);
+                }
+
+                i += 2;
+                if (i < a_pattern.size() && a_pattern[i] != ' ') {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }  // namespace detail
+
+    // True if the pattern parses, fits MAX_SIZE and has at least one concrete byte.
+    [[nodiscard]] constexpr bool IsValid(std::string_view a_pattern) noexcept {
+        std::size_t size = 0;
+        bool concrete = false;
+        const bool parsed = detail::Tokenize(a_pattern, [&](std::byte, bool a_wildcard) {
+            ++size;
+            concrete = concrete || !a_wildcard;
+        });
+        return parsed && concrete && size <= MAX_SIZE;
+    }
+
+    class Pattern {
+    public:
+        // a_pattern must satisfy IsValid.
+        constexpr explicit Pattern(std::string_view a_pattern) noexcept {
+            detail::Tokenize(a_pattern, [&](std::byte a_byte, bool a_wildcard) {
+                _bytes[_size] = a_byte;
+                _mask[_size] = a_wildcard ? std::byte{0x00} : std::byte{0xFF};
+                ++_size;
+            });
+        }
+
+        [[nodiscard]] constexpr std::size_t size() const noexcept { return _size; }
+
+        // a_data must be readable for size() bytes.
+        [[nodiscard]] constexpr bool Match(const std::byte* a_data) const noexcept {
+            for (std::size_t i = 0; i < _size; ++i) {
+                if ((a_data[i] & _mask[i]) != _bytes[i]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Returns the first match in a_haystack, or nullptr. A plain scan, it only ever runs over a handful of bytes.
+        [[nodiscard]] constexpr const std::byte* Find(std::span<const std::byte> a_haystack) const noexcept {
+            if (_size == 0 || a_haystack.size() < _size) {
+                return nullptr;
+            }
+
+            for (std::size_t i = 0; i + _size <= a_haystack.size(); ++i) {
+                if (Match(a_haystack.data() + i)) {
+                    return a_haystack.data() + i;
+                }
+            }
+            return nullptr;
+        }
+
+    private:
+        std::array<std::byte, MAX_SIZE> _bytes{};
+        std::array<std::byte, MAX_SIZE> _mask{};
+        std::size_t _size{0};
+    };
+}  // namespace Signature
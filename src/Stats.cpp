@@ -0,0 +1,110 @@
+#include "Stats.h"
+
+namespace Stats {
+    namespace {
+        constexpr auto PATH = L"Data/SKSE/Plugins/YesImSure.stats"sv;
+
+        // rdtsc runs at a fixed rate on every CPU the game supports, measured against the performance counter on a
+        // background thread so loading does not wait for it
+        void Calibrate() {
+            std::thread([]() {
+                LARGE_INTEGER frequency{};
+                LARGE_INTEGER start{};
+                QueryPerformanceFrequency(&frequency);
+                QueryPerformanceCounter(&start);
+                const auto tscStart = __rdtsc();
+
+                std::this_thread::sleep_for(200ms);
+
+                LARGE_INTEGER end{};
+                QueryPerformanceCounter(&end);
+                const auto tscEnd = __rdtsc();
+
+                const auto elapsed = static_cast<std::uint64_t>(end.QuadPart - start.QuadPart);
+                if (elapsed != 0) {
+                    const auto ticksPerSecond =
+                        (tscEnd - tscStart) * static_cast<std::uint64_t>(frequency.QuadPart) / elapsed;
+                    detail::block->ticksPerSecond.store(ticksPerSecond, std::memory_order_relaxed);
+                }
+            }).detach();
+        }
+
+        // upper bound of the bucket the a_fraction-th call falls into
+        [[nodiscard]] std::uint64_t GetPercentile(const HookStats& a_hook, std::uint64_t a_calls, double a_fraction) {
+            const auto target = static_cast<std::uint64_t>(static_cast<double>(a_calls) * a_fraction);
+            std::uint64_t seen = 0;
+            for (std::size_t i = 0; i < BUCKETS; ++i) {
+                seen += a_hook.histogram[i].load(std::memory_order_relaxed);
+                if (seen > target) {
+                    return std::uint64_t{1} << i;
+                }
+            }
+            return std::uint64_t{1} << (BUCKETS - 1);
+        }
+
+        // The handles stay open for the lifetime of the process, tools read the file while the game runs.
+        void Map() {
+            const auto file = CreateFileW(PATH.data(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                          nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE) {
+                logger::warn("Failed to create the stats file, counting in memory only"sv);
+                return;
+            }
+
+            const auto mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE, 0, sizeof(Block), nullptr);
+            const auto view = mapping ? MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, sizeof(Block)) : nullptr;
+            if (!view) {
+                logger::warn("Failed to map the stats file, counting in memory only"sv);
+                if (mapping) {
+                    CloseHandle(mapping);
+                }
+                CloseHandle(file);
+                return;
+            }
+
+            const auto block = new (view) Block{};
+            block->magic = MAGIC;
+            block->format = FORMAT;
+            block->hookCount = static_cast<std::uint32_t>(block->hooks.size());
+            block->bucketCount = static_cast<std::uint32_t>(BUCKETS);
+            detail::block = block;
+        }
+    }  // namespace
+
+    void Open() {
+        Map();
+        Calibrate();
+    }
+
+    void Dump() {
+        // The async logger's worker may already be gone while atexit handlers run, so the summary is written straight
+        // to the default logger's sinks by a synchronous logger and flushed before returning.
+        const auto global = spdlog::default_logger();
+        if (!global) {
+            return;
+        }
+        spdlog::logger log{"Stats", global->sinks().begin(), global->sinks().end()};
+        log.set_level(global->level());
+
+        const auto& block = *detail::block;
+        const auto ticksPerSecond = block.ticksPerSecond.load(std::memory_order_relaxed);
+        const double nsPerTick = ticksPerSecond != 0 ? 1e9 / static_cast<double>(ticksPerSecond) : 0.0;
+        const auto unit = ticksPerSecond != 0 ? "ns"sv : "ticks"sv;
+        const auto scale = [&](double a_ticks) { return ticksPerSecond != 0 ? a_ticks * nsPerTick : a_ticks; };
+
+        for (std::size_t i = 0; i < block.hooks.size(); ++i) {
+            const auto& hook = block.hooks[i];
+            const auto calls = hook.calls.load(std::memory_order_relaxed);
+            if (calls == 0) {
+                continue;
+            }
+
+            const auto mean = static_cast<double>(hook.ticks.load(std::memory_order_relaxed)) / calls;
+            log.info("{}: {} calls, mean {:.0f}{}, p50 <= {:.0f}{}, p99 <= {:.0f}{}"sv,
+                     Patches::GetCallbackName(static_cast<Patches::Callback>(i)), calls, scale(mean), unit,
+                     scale(static_cast<double>(GetPercentile(hook, calls, 0.5))), unit,
+                     scale(static_cast<double>(GetPercentile(hook, calls, 0.99))), unit);
+        }
+        log.flush();
+    }
+}  // namespace Stats
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+#include "Patches.h"
+
+// Call counts and latency histograms of the hook callbacks. The counters live in a memory mapped file so an external
+// tool can watch them while the game runs, and are logged once more on exit. Recording a call costs two rdtsc and three
+// plain stores: the callbacks only run on the main thread, so the counters are single writer and need no locked
+// instructions, the atomics only keep concurrent readers from seeing torn values.
+namespace Stats {
+    inline constexpr std::uint32_t MAGIC = 0x53534959;  // "YISS"
+    inline constexpr std::uint32_t FORMAT = 1;
+
+    // Bucket i counts calls that took less than 2^i ticks and at least 2^(i-1), the last bucket takes everything above.
+    inline constexpr std::size_t BUCKETS = 48;
+
+    struct HookStats {
+        std::atomic<std::uint64_t> calls;
+        std::atomic<std::uint64_t> ticks;
+        std::array<std::atomic<std::uint64_t>, BUCKETS> histogram;
+    };
+
+    // Layout of the stats file, read as is by external tools.
+    struct Block {
+        std::uint32_t magic;
+        std::uint32_t format;
+        std::uint32_t hookCount;
+        std::uint32_t bucketCount;
+        std::atomic<std::uint64_t> ticksPerSecond;  // 0 until calibrated, shortly after startup
+        std::array<HookStats, std::to_underlying(Patches::Callback::kTotal)> hooks;  // indexed by Patches::Callback
+    };
+
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+    namespace detail {
+        // counts into process memory until Open maps the file
+        inline Block fallback{};
+        inline Block* block{&fallback};
+
+        inline void Add(std::atomic<std::uint64_t>& a_counter, std::uint64_t a_value) noexcept {
+            a_counter.store(a_counter.load(std::memory_order_relaxed) + a_value, std::memory_order_relaxed);
+        }
+    }  // namespace detail
+
+    // Maps the stats file and starts counting into it. Call once, before the hooks are installed.
+    void Open();
+
+    // Logs call count, mean, median and 99th percentile of every callback that ran.
+    void Dump();
+
+    // Records its lifetime as one call of a_hook.
+    class Timer {
+    public:
+        explicit Timer(Patches::Callback a_hook) noexcept : _hook(detail::block->hooks[std::to_underlying(a_hook)]) {}
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        ~Timer() {
+            const std::uint64_t ticks = __rdtsc() - _start;
+            const auto bucket = std::min<std::size_t>(std::bit_width(ticks), BUCKETS - 1);
+            detail::Add(_hook.calls, 1);
+            detail::Add(_hook.ticks, ticks);
+            detail::Add(_hook.histogram[bucket], 1);
+        }
+
+    private:
+        HookStats& _hook;
+        std::uint64_t _start{__rdtsc()};
+    };
+}  // namespace Stats
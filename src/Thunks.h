@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+// Prebuilt machine code for the thunks written into the caves. Every thunk is an optional prologue followed by
+//
+//     call qword ptr [rip + 6]   ; FF 15 06 00 00 00
+//     jmp  qword ptr [rip + 8]   ; FF 25 08 00 00 00
+//     dq   callAddr
+//     dq   retAddr
+//
+// so only the two address slots change between installs.
+namespace Patches {
+    enum class Thunk : std::uint8_t {
+        kNone,            // nop fill only
+        kCall,            // call [callback]; jmp [ret]
+        kPoisonCallback,  // mov ecx, 2; call rdx; call [callback]; jmp [ret]
+        kPoisonNotify,    // mov edx, 0; mov r8d, 1; call [callback]; jmp [ret]
+        kEnchantNotify,   // mov rcx, rbx; mov rdx, rsi; call [callback]; jmp [ret]
+    };
+
+    inline constexpr std::size_t MAX_THUNK_SIZE = 48;
+
+    class ThunkTemplate {
+    public:
+        using code_type = std::array<std::byte, MAX_THUNK_SIZE>;
+
+        consteval explicit ThunkTemplate(std::initializer_list<std::uint8_t> a_prologue = {}) noexcept {
+            for (const auto byte : a_prologue) {
+                Emit(byte);
+            }
+
+            for (const auto byte : {0xFF, 0x15, 0x06, 0x00, 0x00, 0x00, 0xFF, 0x25, 0x08, 0x00, 0x00, 0x00}) {
+                Emit(static_cast<std::uint8_t>(byte));
+            }
+
+            _callSlot = _size;
+            _size += 8;
+            _retSlot = _size;
+            _size += 8;
+        }
+
+        // Placeholder for caves that are only nop filled.
+        [[nodiscard]] static consteval ThunkTemplate Empty() noexcept {
+            ThunkTemplate thunk;
+            thunk._code = {};
+            thunk._size = 0;
+            return thunk;
+        }
+
+        [[nodiscard]] constexpr std::size_t size() const noexcept { return _size; }
+        [[nodiscard]] constexpr std::size_t call_slot() const noexcept { return _callSlot; }
+        [[nodiscard]] constexpr std::size_t ret_slot() const noexcept { return _retSlot; }
+
+        // Returns the thunk with both address slots filled in, only the first size() bytes are meaningful.
+        [[nodiscard]] constexpr code_type Instantiate(std::uint64_t a_callAddr,
+                                                      std::uint64_t a_retAddr) const noexcept {
+            auto code = _code;
+            if (_size != 0) {
+                Store(code, _callSlot, a_callAddr);
+                Store(code, _retSlot, a_retAddr);
+            }
+            return code;
+        }
+
+    private:
+        consteval void Emit(std::uint8_t a_byte) noexcept { _code[_size++] = static_cast<std::byte>(a_byte); }
+
+        static constexpr void Store(code_type& a_code, std::size_t a_offset, std::uint64_t a_value) noexcept {
+            for (std::size_t i = 0; i < 8; ++i) {
+                a_code[a_offset + i] = static_cast<std::byte>((a_value >> (i * 8)) & 0xFF);
+            }
+        }
+
+        code_type _code{};
+        std::size_t _size{0};
+        std::size_t _callSlot{0};
+        std::size_t _retSlot{0};
+    };
+
+    namespace detail {
+        inline constexpr auto NONE_THUNK = ThunkTemplate::Empty();
+        inline constexpr ThunkTemplate CALL_THUNK{};
+        inline constexpr ThunkTemplate POISON_CALLBACK_THUNK{{
+            0xB9, 0x02, 0x00, 0x00, 0x00,  // mov ecx, 2
+            0xFF, 0xD2,                    // call rdx
+        }};
+        inline constexpr ThunkTemplate POISON_NOTIFY_THUNK{{
+            0xBA, 0x00, 0x00, 0x00, 0x00,        // mov edx, 0
+            0x41, 0xB8, 0x01, 0x00, 0x00, 0x00,  // mov r8d, 1
+        }};
+        inline constexpr ThunkTemplate ENCHANT_NOTIFY_THUNK{{
+            0x48, 0x89, 0xD9,  // mov rcx, rbx ; rbx == const char*
+            0x48, 0x89, 0xF2,  // mov rdx, rsi ; rsi == TESForm*
+        }};
+    }  // namespace detail
+
+    [[nodiscard]] constexpr const ThunkTemplate& GetThunkTemplate(Thunk a_thunk) noexcept {
+        switch (a_thunk) {
+            case Thunk::kCall:
+                return detail::CALL_THUNK;
+            case Thunk::kPoisonCallback:
+                return detail::POISON_CALLBACK_THUNK;
+            case Thunk::kPoisonNotify:
+                return detail::POISON_NOTIFY_THUNK;
+            case Thunk::kEnchantNotify:
+                return detail::ENCHANT_NOTIFY_THUNK;
+            case Thunk::kNone:
+            default:
+                return detail::NONE_THUNK;
+        }
+    }
+
+    [[nodiscard]] constexpr std::size_t GetThunkSize(Thunk a_thunk) noexcept {
+        return GetThunkTemplate(a_thunk).size();
+    }
+
+    namespace detail {
+        [[nodiscard]] consteval bool IsCallThunkEncoded() {
+            constexpr std::array<std::uint8_t, 28> expected{
+                0xFF, 0x15, 0x06, 0x00, 0x00, 0x00,              // call [rip + 6]
+                0xFF, 0x25, 0x08, 0x00, 0x00, 0x00,              // jmp [rip + 8]
+                0x88, 0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11,  // callAddr
+                0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,  // retAddr
+            };
+
+            const auto code = CALL_THUNK.Instantiate(0x1122334455667788, 0x0807060504030201);
+            if (CALL_THUNK.size() != expected.size()) {
+                return false;
+            }
+            for (std::size_t i = 0; i < expected.size(); ++i) {
+                if (code[i] != static_cast<std::byte>(expected[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        static_assert(IsCallThunkEncoded());
+        static_assert(GetThunkSize(Thunk::kNone) == 0);
+        static_assert(GetThunkSize(Thunk::kPoisonCallback) == 7 + 28);
+        static_assert(GetThunkSize(Thunk::kPoisonNotify) == 11 + 28);
+        static_assert(GetThunkSize(Thunk::kEnchantNotify) == 6 + 28);
+        static_assert(POISON_NOTIFY_THUNK.ret_slot() == 11 + 20);
+    }  // namespace detail
+}  // namespace Patches
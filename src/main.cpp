@@ -1,5 +1,10 @@
+#include "FileWatcher.h"
 #include "Hooks.h"
+#include "Menus.h"
+#include "MessageBoxes.h"
+#include "Profiler.h"
 #include "Settings.h"
+#include "Stats.h"
 
 #include <stddef.h>
 
@@ -9,6 +14,12 @@ using namespace SKSE::log;
 using namespace SKSE::stl;
 
 namespace {
+    [[nodiscard]] spdlog::level::level_enum GetLogLevel() {
+        const auto level = std::clamp<std::int64_t>(*Settings::LogLevel, spdlog::level::trace, spdlog::level::off);
+        return static_cast<spdlog::level::level_enum>(level);
+    }
+
+    // Settings must be loaded first, they pick the logging mode.
     void InitializeLogging() {
         auto path = log_directory();
         if (!path) {
@@ -20,12 +31,25 @@ namespace {
         std::shared_ptr<spdlog::logger> log;
         if (IsDebuggerPresent()) {
             log = std::make_shared<spdlog::logger>("Global", std::make_shared<spdlog::sinks::msvc_sink_mt>());
+            log->flush_on(spdlog::level::info);
+        } else if (*Settings::AsyncLogging) {
+            // the game thread formats into spdlog's mutex guarded queue, a single worker does the file I/O
+            const auto queueSize = static_cast<std::size_t>(std::max<std::int64_t>(*Settings::LogQueueSize, 1));
+            spdlog::init_thread_pool(queueSize, 1);
+            const auto policy = *Settings::BlockOnOverflow ? spdlog::async_overflow_policy::block
+                                                           : spdlog::async_overflow_policy::overrun_oldest;
+            log = std::make_shared<spdlog::async_logger>(
+                "Global", std::make_shared<spdlog::sinks::basic_file_sink_mt>(path->string(), true),
+                spdlog::thread_pool(), policy);
+            log->flush_on(spdlog::level::err);
+
+            spdlog::flush_every(std::chrono::seconds(std::max<std::int64_t>(*Settings::FlushInterval, 1)));
         } else {
             log = std::make_shared<spdlog::logger>(
                 "Global", std::make_shared<spdlog::sinks::basic_file_sink_mt>(path->string(), true));
+            log->flush_on(spdlog::level::info);
         }
-        log->set_level(spdlog::level::info);
-        log->flush_on(spdlog::level::info);
+        log->set_level(GetLogLevel());
 
         spdlog::set_default_logger(std::move(log));
         spdlog::set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%n] [%l] [%t] [%s:%#] %v");
@@ -33,7 +57,26 @@ namespace {
 }  // namespace
 
 SKSEPluginLoad(const LoadInterface* skse) {
-    InitializeLogging();
+    const auto loadStart = Profiler::clock_type::now();
+
+    std::string settingsWarnings;
+    {
+        Profiler::ScopedTimer timer{"Settings::Load"sv};
+        settingsWarnings = Settings::Load();
+    }
+
+    {
+        Profiler::ScopedTimer timer{"InitializeLogging"sv};
+        InitializeLogging();
+    }
+
+    if (!settingsWarnings.empty()) {
+        log::warn("{}"sv, settingsWarnings);
+    }
+
+    // registered after the logger exists, so it is still alive when the handler runs at unload
+    Stats::Open();
+    std::atexit(Stats::Dump);
 
     auto* plugin = PluginDeclaration::GetSingleton();
     auto version = plugin->GetVersion();
@@ -43,8 +86,39 @@ SKSEPluginLoad(const LoadInterface* skse) {
 
     SKSE::AllocTrampoline(1u << 4);
 
-    Settings::Load();
-    Hooks::Install();
+    {
+        Profiler::ScopedTimer timer{"Hooks::Install"sv};
+        Hooks::Install();
+    }
+
+    {
+        Profiler::ScopedTimer timer{"MessageBoxes::Install"sv};
+        MessageBoxes::Install();
+    }
+
+    GetMessagingInterface()->RegisterListener([](MessagingInterface::Message* a_msg) {
+        if (a_msg->type == MessagingInterface::kDataLoaded) {
+            Menus::Register();
+            MessageBoxes::Rebuild();
+        }
+    });
+
+    if (*Settings::HotReload) {
+        FileWatcher::Watch(std::filesystem::path{Settings::PATH}, []() {
+            SKSE::GetTaskInterface()->AddTask([]() {
+                if (Settings::Reload()) {
+                    spdlog::default_logger()->set_level(GetLogLevel());
+                    logger::info("Reloaded settings"sv);
+                    Hooks::Sync();
+                    MessageBoxes::Rebuild();
+                    logger::debug("Reload profile: {}"sv, Profiler::Flush());
+                }
+            });
+        });
+    }
+
+    Profiler::Record("SKSEPluginLoad"sv, Profiler::clock_type::now() - loadStart);
+    log::info("Load profile: {}"sv, Profiler::Flush());
 
     log::info("{} has finished loading.", plugin->GetName());
     return true;
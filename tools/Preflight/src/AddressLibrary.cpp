@@ -0,0 +1,119 @@
+#include "AddressLibrary.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+
+namespace Preflight {
+    namespace {
+        class Reader {
+        public:
+            explicit Reader(std::span<const char> a_data) noexcept : _data(a_data) {}
+
+            template <class T>
+            [[nodiscard]] T Read() {
+                if (_data.size() - _pos < sizeof(T)) {
+                    throw std::runtime_error("address library is truncated");
+                }
+                T value;
+                std::memcpy(&value, _data.data() + _pos, sizeof(T));
+                _pos += sizeof(T);
+                return value;
+            }
+
+            void Skip(std::size_t a_size) {
+                if (_data.size() - _pos < a_size) {
+                    throw std::runtime_error("address library is truncated");
+                }
+                _pos += a_size;
+            }
+
+        private:
+            std::span<const char> _data;
+            std::size_t _pos{0};
+        };
+
+        // The low nibble of each entry's type byte encodes the id and the high nibble the offset, both mostly as small
+        // deltas from the previous entry.
+        [[nodiscard]] std::uint64_t ReadDelta(Reader& a_reader, std::uint8_t a_code, std::uint64_t a_prev) {
+            switch (a_code) {
+                case 0:
+                    return a_reader.Read<std::uint64_t>();
+                case 1:
+                    return a_prev + 1;
+                case 2:
+                    return a_prev + a_reader.Read<std::uint8_t>();
+                case 3:
+                    return a_prev - a_reader.Read<std::uint8_t>();
+                case 4:
+                    return a_prev + a_reader.Read<std::uint16_t>();
+                case 5:
+                    return a_prev - a_reader.Read<std::uint16_t>();
+                case 6:
+                    return a_reader.Read<std::uint16_t>();
+                case 7:
+                    return a_reader.Read<std::uint32_t>();
+                default:
+                    throw std::runtime_error("address library has an unknown entry type");
+            }
+        }
+    }  // namespace
+
+    AddressLibrary::AddressLibrary(const std::filesystem::path& a_path) {
+        std::ifstream file{a_path, std::ios::binary};
+        if (!file) {
+            throw std::runtime_error("cannot open " + a_path.string());
+        }
+        const std::vector<char> data{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+
+        Reader reader{data};
+        _format = reader.Read<std::int32_t>();
+        if (_format != 1 && _format != 2) {
+            throw std::runtime_error(a_path.string() + " is not an address library database");
+        }
+
+        for (auto& part : _version) {
+            part = reader.Read<std::int32_t>();
+        }
+
+        const auto nameLength = reader.Read<std::int32_t>();
+        reader.Skip(static_cast<std::size_t>(std::max(nameLength, 0)));
+
+        const auto pointerSize = static_cast<std::uint64_t>(reader.Read<std::int32_t>());
+        const auto count = reader.Read<std::int32_t>();
+        if (pointerSize == 0 || count < 0) {
+            throw std::runtime_error(a_path.string() + " has a corrupt header");
+        }
+
+        _offsets.reserve(static_cast<std::size_t>(count));
+        std::uint64_t id = 0;
+        std::uint64_t offset = 0;
+        for (std::int32_t i = 0; i < count; ++i) {
+            const auto type = reader.Read<std::uint8_t>();
+            const auto lo = static_cast<std::uint8_t>(type & 0xF);
+            const auto hi = static_cast<std::uint8_t>(type >> 4);
+            const bool scaled = (hi & 8) != 0;
+
+            id = ReadDelta(reader, lo, id);
+            offset = ReadDelta(reader, hi & 7, scaled ? offset / pointerSize : offset);
+            if (scaled) {
+                offset *= pointerSize;
+            }
+
+            _offsets.emplace_back(id, offset);
+        }
+
+        std::ranges::sort(_offsets);
+    }
+
+    std::optional<std::uint64_t> AddressLibrary::GetOffset(std::uint64_t a_id) const {
+        const auto it = std::ranges::lower_bound(_offsets, a_id, {}, &std::pair<std::uint64_t, std::uint64_t>::first);
+        if (it == _offsets.end() || it->first != a_id) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+}  // namespace Preflight
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace Preflight {
+    // An address library database as shipped for SE (version-*.bin, format 1) or AE (versionlib-*.bin, format 2),
+    // unpacked into id/offset pairs.
+    class AddressLibrary {
+    public:
+        // Throws std::runtime_error if a_path cannot be read or is not a database.
+        explicit AddressLibrary(const std::filesystem::path& a_path);
+
+        [[nodiscard]] std::int32_t format() const noexcept { return _format; }
+        [[nodiscard]] const std::array<std::int32_t, 4>& version() const noexcept { return _version; }
+        [[nodiscard]] std::size_t size() const noexcept { return _offsets.size(); }
+
+        // Offset of a_id from the image base.
+        [[nodiscard]] std::optional<std::uint64_t> GetOffset(std::uint64_t a_id) const;
+
+    private:
+        std::int32_t _format{0};
+        std::array<std::int32_t, 4> _version{};
+        std::vector<std::pair<std::uint64_t, std::uint64_t>> _offsets;  // sorted by id
+    };
+}  // namespace Preflight
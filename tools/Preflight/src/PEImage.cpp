@@ -0,0 +1,171 @@
+#include "PEImage.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <stdexcept>
+
+namespace Preflight {
+    namespace {
+        template <class T>
+        [[nodiscard]] T ReadAt(const std::vector<std::byte>& a_data, std::size_t a_offset) {
+            if (a_offset > a_data.size() || a_data.size() - a_offset < sizeof(T)) {
+                throw std::runtime_error("executable is truncated");
+            }
+            T value;
+            std::memcpy(&value, a_data.data() + a_offset, sizeof(T));
+            return value;
+        }
+
+        template <class T>
+        [[nodiscard]] std::optional<T> TryReadAt(std::span<const std::byte> a_data, std::size_t a_offset) {
+            if (a_offset > a_data.size() || a_data.size() - a_offset < sizeof(T)) {
+                return std::nullopt;
+            }
+            T value;
+            std::memcpy(&value, a_data.data() + a_offset, sizeof(T));
+            return value;
+        }
+
+        constexpr std::uint32_t RT_VERSION = 16;
+        constexpr std::uint32_t VS_FFI_SIGNATURE = 0xFEEF04BD;
+
+        // The first entry of the resource directory at a_offset, or the one with a_id. Returns the entry's
+        // OffsetToData, with the high bit set if it points to another directory.
+        [[nodiscard]] std::optional<std::uint32_t> FindResourceEntry(std::span<const std::byte> a_resources,
+                                                                     std::size_t a_offset,
+                                                                     std::optional<std::uint32_t> a_id) {
+            const auto named = TryReadAt<std::uint16_t>(a_resources, a_offset + 12);
+            const auto ids = TryReadAt<std::uint16_t>(a_resources, a_offset + 14);
+            if (!named || !ids) {
+                return std::nullopt;
+            }
+
+            for (std::size_t i = 0; i < std::size_t{*named} + *ids; ++i) {
+                const auto entry = a_offset + 16 + i * 8;
+                const auto name = TryReadAt<std::uint32_t>(a_resources, entry);
+                const auto offset = TryReadAt<std::uint32_t>(a_resources, entry + 4);
+                if (name && offset && (!a_id || *name == *a_id)) {
+                    return offset;
+                }
+            }
+            return std::nullopt;
+        }
+    }  // namespace
+
+    PEImage::PEImage(const std::filesystem::path& a_path) {
+        std::ifstream file{a_path, std::ios::binary};
+        if (!file) {
+            throw std::runtime_error("cannot open " + a_path.string());
+        }
+
+        std::vector<char> raw{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+        _data.resize(raw.size());
+        std::memcpy(_data.data(), raw.data(), raw.size());
+
+        if (ReadAt<std::uint16_t>(_data, 0) != 0x5A4D) {  // "MZ"
+            throw std::runtime_error(a_path.string() + " is not an executable");
+        }
+
+        const auto nt = static_cast<std::size_t>(ReadAt<std::uint32_t>(_data, 0x3C));
+        if (ReadAt<std::uint32_t>(_data, nt) != 0x00004550) {  // "PE\0\0"
+            throw std::runtime_error(a_path.string() + " is not a PE image");
+        }
+
+        const auto fileHeader = nt + 4;
+        const auto sectionCount = ReadAt<std::uint16_t>(_data, fileHeader + 2);
+        _timeDateStamp = ReadAt<std::uint32_t>(_data, fileHeader + 4);
+        const auto optionalHeaderSize = ReadAt<std::uint16_t>(_data, fileHeader + 16);
+
+        const auto optionalHeader = fileHeader + 20;
+        if (ReadAt<std::uint16_t>(_data, optionalHeader) != 0x20B) {  // PE32+
+            throw std::runtime_error(a_path.string() + " is not a 64 bit image");
+        }
+        _sizeOfImage = ReadAt<std::uint32_t>(_data, optionalHeader + 56);
+
+        auto section = optionalHeader + optionalHeaderSize;
+        for (std::uint16_t i = 0; i < sectionCount; ++i, section += 40) {
+            const auto name = ReadAt<std::array<char, 8>>(_data, section);
+            _sections.push_back({{name.data(), strnlen(name.data(), name.size())},
+                                 ReadAt<std::uint32_t>(_data, section + 12),
+                                 ReadAt<std::uint32_t>(_data, section + 8),
+                                 ReadAt<std::uint32_t>(_data, section + 20),
+                                 ReadAt<std::uint32_t>(_data, section + 16),
+                                 ReadAt<std::uint32_t>(_data, section + 36)});
+        }
+
+        const auto resourceDirectory = optionalHeader + 128;  // data directory 2, after the PE32+ fields
+        if (optionalHeaderSize >= 136) {
+            ReadFileVersion(ReadAt<std::uint32_t>(_data, resourceDirectory),
+                            ReadAt<std::uint32_t>(_data, resourceDirectory + 4));
+        }
+    }
+
+    // Walks type, name and language down to the first version resource, then reads the VS_FIXEDFILEINFO in it. The
+    // image is left without a version if any step is missing.
+    void PEImage::ReadFileVersion(std::uint32_t a_rva, std::uint32_t a_size) {
+        const auto resources = Read(a_rva, a_size);
+        if (resources.empty()) {
+            return;
+        }
+
+        constexpr std::uint32_t SUBDIRECTORY = 0x80000000;
+        auto entry = FindResourceEntry(resources, 0, RT_VERSION);
+        for (int level = 0; level < 2 && entry && (*entry & SUBDIRECTORY) != 0; ++level) {
+            entry = FindResourceEntry(resources, *entry & ~SUBDIRECTORY, std::nullopt);
+        }
+        if (!entry || (*entry & SUBDIRECTORY) != 0) {
+            return;
+        }
+
+        const auto dataRva = TryReadAt<std::uint32_t>(resources, *entry);
+        const auto dataSize = TryReadAt<std::uint32_t>(resources, *entry + 4);
+        const auto info = dataRva && dataSize ? Read(*dataRva, *dataSize) : std::span<const std::byte>{};
+
+        // VS_VERSIONINFO starts with three words and its key, the fixed info follows on a 4 byte boundary
+        for (std::size_t offset = 0; offset + 16 <= info.size(); offset += 4) {
+            if (TryReadAt<std::uint32_t>(info, offset) == VS_FFI_SIGNATURE) {
+                const auto ms = *TryReadAt<std::uint32_t>(info, offset + 8);
+                const auto ls = *TryReadAt<std::uint32_t>(info, offset + 12);
+                _fileVersion = std::array{static_cast<std::uint16_t>(ms >> 16), static_cast<std::uint16_t>(ms),
+                                          static_cast<std::uint16_t>(ls >> 16), static_cast<std::uint16_t>(ls)};
+                return;
+            }
+        }
+    }
+
+    const PEImage::Section* PEImage::FindSection(std::uint64_t a_rva) const noexcept {
+        const auto it = std::ranges::find_if(_sections, [&](const Section& a_section) {
+            const auto size = std::max(a_section.virtualSize, a_section.rawSize);
+            return a_rva >= a_section.virtualAddress && a_rva < std::uint64_t{a_section.virtualAddress} + size;
+        });
+        return it != _sections.end() ? std::addressof(*it) : nullptr;
+    }
+
+    std::span<const std::byte> PEImage::Read(std::uint64_t a_rva, std::size_t a_size) const noexcept {
+        const auto section = FindSection(a_rva);
+        if (!section) {
+            return {};
+        }
+
+        const auto offset = a_rva - section->virtualAddress;
+        if (offset + a_size > section->rawSize) {
+            return {};
+        }
+
+        const auto data = GetData(*section);
+        return offset + a_size <= data.size() ? data.subspan(offset, a_size) : std::span<const std::byte>{};
+    }
+
+    std::span<const std::byte> PEImage::GetData(const Section& a_section) const noexcept {
+        if (a_section.rawOffset >= _data.size()) {
+            return {};
+        }
+        const auto size = std::min<std::size_t>(a_section.rawSize, _data.size() - a_section.rawOffset);
+        return {_data.data() + a_section.rawOffset, size};
+    }
+}  // namespace Preflight
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Preflight {
+    // A 64 bit PE executable read from disk, addressed by RVA the same way the loaded module is.
+    class PEImage {
+    public:
+        struct Section {
+            [[nodiscard]] bool executable() const noexcept { return (characteristics & 0x20000000) != 0; }
+
+            std::string name;
+            std::uint32_t virtualAddress;
+            std::uint32_t virtualSize;
+            std::uint32_t rawOffset;
+            std::uint32_t rawSize;
+            std::uint32_t characteristics;
+        };
+
+        // Throws std::runtime_error if a_path cannot be read or is not a 64 bit PE image.
+        explicit PEImage(const std::filesystem::path& a_path);
+
+        [[nodiscard]] std::uint32_t time_date_stamp() const noexcept { return _timeDateStamp; }
+        [[nodiscard]] std::uint32_t size_of_image() const noexcept { return _sizeOfImage; }
+
+        // The file version from the VS_FIXEDFILEINFO of the version resource, if the image has one.
+        [[nodiscard]] const std::optional<std::array<std::uint16_t, 4>>& file_version() const noexcept {
+            return _fileVersion;
+        }
+
+        // The section holding a_rva, or nullptr.
+        [[nodiscard]] const Section* FindSection(std::uint64_t a_rva) const noexcept;
+
+        // The file bytes behind [a_rva, a_rva + a_size), empty unless all of them lie in one section's raw data.
+        [[nodiscard]] std::span<const std::byte> Read(std::uint64_t a_rva, std::size_t a_size) const noexcept;
+
+        // The raw data of a_section.
+        [[nodiscard]] std::span<const std::byte> GetData(const Section& a_section) const noexcept;
+
+    private:
+        void ReadFileVersion(std::uint32_t a_rva, std::uint32_t a_size);
+
+        std::vector<std::byte> _data;
+        std::vector<Section> _sections;
+        std::uint32_t _timeDateStamp{0};
+        std::uint32_t _sizeOfImage{0};
+        std::optional<std::array<std::uint16_t, 4>> _fileVersion;
+    };
+}  // namespace Preflight
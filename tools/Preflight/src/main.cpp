@@ -0,0 +1,334 @@
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "AddressLibrary.h"
+#include "PEImage.h"
+#include "Patches.h"
+#include "Signature.h"
+
+// Checks every cave and call site Hooks::Install would write against an executable and its address library database,
+// without the game. Prints one line per check and exits with 0 if everything passed, 1 if anything failed and 2 if the
+// files could not be read.
+namespace {
+    using namespace std::literals;
+    using Preflight::AddressLibrary;
+    using Preflight::PEImage;
+    using ull = unsigned long long;
+
+    class Report {
+    public:
+        explicit Report(bool a_verbose) noexcept : _verbose(a_verbose) {}
+
+        void Pass(std::string_view a_patch, const std::string& a_what, const std::string& a_detail = {}) {
+            ++_passed;
+            if (_verbose) {
+                Print("PASS"sv, a_patch, a_what, a_detail);
+            }
+        }
+
+        void Fail(std::string_view a_patch, const std::string& a_what, const std::string& a_detail) {
+            ++_failed;
+            Print("FAIL"sv, a_patch, a_what, a_detail);
+        }
+
+        [[nodiscard]] std::size_t passed() const noexcept { return _passed; }
+        [[nodiscard]] std::size_t failed() const noexcept { return _failed; }
+
+    private:
+        static void Print(std::string_view a_result, std::string_view a_patch, const std::string& a_what,
+                          const std::string& a_detail) {
+            std::printf("%.*s  %-26.*s %s%s%s\n", static_cast<int>(a_result.size()), a_result.data(),
+                        static_cast<int>(a_patch.size()), a_patch.data(), a_what.c_str(), a_detail.empty() ? "" : ": ",
+                        a_detail.c_str());
+        }
+
+        bool _verbose;
+        std::size_t _passed{0};
+        std::size_t _failed{0};
+    };
+
+    // printf into a std::string, <format> is not available on every Linux toolchain yet
+    [[nodiscard]] std::string Format(const char* a_fmt, ...) {
+        va_list args;
+        va_start(args, a_fmt);
+        va_list copy;
+        va_copy(copy, args);
+        const auto size = std::vsnprintf(nullptr, 0, a_fmt, copy);
+        va_end(copy);
+
+        std::string str(static_cast<std::size_t>(std::max(size, 0)), '\0');
+        std::vsnprintf(str.data(), str.size() + 1, a_fmt, args);
+        va_end(args);
+        return str;
+    }
+
+    [[nodiscard]] std::string ToHex(std::span<const std::byte> a_bytes) {
+        std::string hex;
+        for (const auto byte : a_bytes) {
+            if (!hex.empty()) {
+                hex += ' ';
+            }
+            hex += Format("%02X", static_cast<unsigned>(byte));
+        }
+        return hex;
+    }
+
+    // Code the patch jumps to or writes over has to be in an executable section and present in the file.
+    [[nodiscard]] bool IsCode(const PEImage& a_image, std::uint64_t a_rva, std::size_t a_size) {
+        const auto section = a_image.FindSection(a_rva);
+        return section && section->executable() && a_image.Read(a_rva, a_size).size() == a_size;
+    }
+
+    // The first bytes of every cave as signatures, keyed by function id and cave start. Recorded from an executable the
+    // patches are known to work on, with operands that move between versions replaced by ?? by hand.
+    using CaveSignatures = std::map<std::pair<std::uint64_t, std::size_t>, std::string>;
+
+    [[nodiscard]] std::string_view GetRuntimeName(Patches::Runtime a_runtime) noexcept {
+        return a_runtime == Patches::Runtime::kSE ? "SE"sv : "AE"sv;
+    }
+
+    // One cave per line: runtime, function id, cave start and the signature, e.g. "SE 50452 0x5F 48 8B ?? ?? E8".
+    // Lines of the other runtime and lines starting with # are skipped.
+    [[nodiscard]] CaveSignatures LoadCaveSignatures(const std::filesystem::path& a_path, Patches::Runtime a_runtime) {
+        std::ifstream file{a_path};
+        if (!file) {
+            throw std::runtime_error("cannot open " + a_path.string());
+        }
+
+        CaveSignatures signatures;
+        std::string line;
+        for (std::size_t number = 1; std::getline(file, line); ++number) {
+            if (line.empty() || line.front() == '#') {
+                continue;
+            }
+
+            std::istringstream stream{line};
+            std::string runtime;
+            std::uint64_t id = 0;
+            std::size_t start = 0;
+            std::string signature;
+            if (!(stream >> runtime >> id >> std::hex >> start) || !std::getline(stream >> std::ws, signature)) {
+                throw std::runtime_error(Format("%s:%zu: expected runtime, id, start and signature",
+                                                a_path.string().c_str(), number));
+            }
+            if (!Signature::IsValid(signature)) {
+                throw std::runtime_error(Format("%s:%zu: invalid signature", a_path.string().c_str(), number));
+            }
+            if (runtime == GetRuntimeName(a_runtime)) {
+                signatures[{id, start}] = std::move(signature);
+            }
+        }
+        return signatures;
+    }
+
+    void CheckCave(const PEImage& a_image, const AddressLibrary& a_library, const Patches::Cave& a_cave,
+                   const CaveSignatures* a_signatures, Report& a_report) {
+        const auto patch = Patches::GetPatchName(a_cave.patch);
+        const auto what = Format("cave %llu+0x%zX", static_cast<ull>(a_cave.funcID), a_cave.start);
+
+        const auto funcBase = a_library.GetOffset(a_cave.funcID);
+        if (!funcBase) {
+            a_report.Fail(patch, what, "id not in the address library");
+            return;
+        }
+
+        const auto rva = *funcBase + a_cave.start;
+        if (!IsCode(a_image, rva, a_cave.size())) {
+            a_report.Fail(patch, what, Format("rva 0x%llX is not code in the executable", static_cast<ull>(rva)));
+            return;
+        }
+
+        const auto thunkSize = Patches::GetThunkSize(a_cave.thunk);
+        if (thunkSize > a_cave.size()) {
+            a_report.Fail(patch, what, Format("%zu byte thunk does not fit %zu bytes", thunkSize, a_cave.size()));
+            return;
+        }
+
+        if (a_cave.thunk != Patches::Thunk::kNone && !IsCode(a_image, *funcBase + a_cave.jumpOut, 1)) {
+            a_report.Fail(patch, what, Format("jump out +0x%zX is not code", a_cave.jumpOut));
+            return;
+        }
+
+        if (a_cave.callbackID != 0) {
+            const auto callback = a_library.GetOffset(a_cave.callbackID);
+            if (!callback || !IsCode(a_image, *callback, 1)) {
+                a_report.Fail(patch, what,
+                              Format("callback id %llu does not resolve to code", static_cast<ull>(a_cave.callbackID)));
+                return;
+            }
+        }
+
+        const auto head = ToHex(a_image.Read(rva, std::min<std::size_t>(a_cave.size(), 16)));
+        if (a_signatures) {
+            const auto it = a_signatures->find({a_cave.funcID, a_cave.start});
+            if (it == a_signatures->end()) {
+                a_report.Fail(patch, what, "no recorded signature");
+                return;
+            }
+
+            const Signature::Pattern pattern{it->second};
+            const auto bytes = a_image.Read(rva, pattern.size());
+            if (bytes.size() != pattern.size() || !pattern.Match(bytes.data())) {
+                a_report.Fail(patch, what, Format("expected %s, found %s", it->second.c_str(), ToHex(bytes).c_str()));
+                return;
+            }
+        }
+
+        a_report.Pass(patch, what,
+                      Format("rva 0x%llX, %zu/%zu bytes, %s%s", static_cast<ull>(rva), thunkSize, a_cave.size(),
+                             head.c_str(), a_signatures ? ", matches the recording" : ""));
+    }
+
+    void CheckCallSite(const PEImage& a_image, const AddressLibrary& a_library, const Patches::CallSite& a_site,
+                       Report& a_report) {
+        const auto patch = Patches::GetPatchName(a_site.patch);
+        const auto what = Format("call site %llu+0x%zX", static_cast<ull>(a_site.funcID), a_site.offset);
+
+        const auto funcBase = a_library.GetOffset(a_site.funcID);
+        if (!funcBase) {
+            a_report.Fail(patch, what, "id not in the address library");
+            return;
+        }
+
+        const Signature::Pattern pattern{a_site.signature};
+        const auto rva = *funcBase + a_site.offset;
+        if (!IsCode(a_image, rva, pattern.size())) {
+            a_report.Fail(patch, what, Format("rva 0x%llX is not code in the executable", static_cast<ull>(rva)));
+            return;
+        }
+
+        const auto bytes = a_image.Read(rva, pattern.size());
+        if (!pattern.Match(bytes.data())) {
+            a_report.Fail(patch, what,
+                          Format("expected %.*s, found %s", static_cast<int>(a_site.signature.size()),
+                                 a_site.signature.data(), ToHex(bytes).c_str()));
+            return;
+        }
+
+        a_report.Pass(patch, what, Format("rva 0x%llX, %s", static_cast<ull>(rva), ToHex(bytes).c_str()));
+    }
+
+    struct Options {
+        bool verbose{false};
+        std::filesystem::path signatures;  // recorded cave signatures to check against, empty to skip
+        std::filesystem::path record;      // where to record the cave signatures, empty to skip
+    };
+
+    // Offsets from a database for another build point at unrelated code, so the executable has to be that build.
+    void CheckVersion(const PEImage& a_image, const AddressLibrary& a_library, Report& a_report) {
+        const auto& expected = a_library.version();
+        const auto& actual = a_image.file_version();
+        if (!actual) {
+            a_report.Fail("executable"sv, "version", "no version resource");
+            return;
+        }
+
+        const auto text = Format("%d.%d.%d.%d", (*actual)[0], (*actual)[1], (*actual)[2], (*actual)[3]);
+        if (!std::ranges::equal(*actual, expected)) {
+            a_report.Fail("executable"sv, "version",
+                          Format("%s, the address library is for %d.%d.%d.%d", text.c_str(), expected[0], expected[1],
+                                 expected[2], expected[3]));
+            return;
+        }
+
+        a_report.Pass("executable"sv, "version", text);
+    }
+
+    // Writes the first bytes of every cave in the format LoadCaveSignatures reads.
+    void RecordCaveSignatures(const PEImage& a_image, const AddressLibrary& a_library, Patches::Runtime a_runtime,
+                              const std::filesystem::path& a_path) {
+        std::ofstream file{a_path};
+        if (!file) {
+            throw std::runtime_error("cannot write " + a_path.string());
+        }
+
+        const auto& version = a_library.version();
+        file << Format("# %d.%d.%d.%d\n", version[0], version[1], version[2], version[3]);
+        for (const auto& cave : Patches::GetCaves(a_runtime)) {
+            const auto rva = *a_library.GetOffset(cave.funcID) + cave.start;
+            const auto bytes = a_image.Read(rva, std::min(cave.size(), Signature::MAX_SIZE));
+            file << GetRuntimeName(a_runtime) << ' ' << cave.funcID << Format(" 0x%zX ", cave.start) << ToHex(bytes)
+                 << '\n';
+        }
+    }
+
+    int Run(const PEImage& a_image, const AddressLibrary& a_library, const Options& a_options) {
+        const auto runtime = a_library.format() == 1 ? Patches::Runtime::kSE : Patches::Runtime::kAE;
+        const auto& version = a_library.version();
+        const auto name = GetRuntimeName(runtime);
+        std::printf("%.*s %d.%d.%d.%d, %zu ids, executable timestamp 0x%08X, image size 0x%X\n",
+                    static_cast<int>(name.size()), name.data(), version[0], version[1], version[2], version[3],
+                    a_library.size(), a_image.time_date_stamp(), a_image.size_of_image());
+
+        std::optional<CaveSignatures> signatures;
+        if (!a_options.signatures.empty()) {
+            signatures = LoadCaveSignatures(a_options.signatures, runtime);
+        }
+
+        Report report{a_options.verbose};
+        CheckVersion(a_image, a_library, report);
+        for (const auto& cave : Patches::GetCaves(runtime)) {
+            CheckCave(a_image, a_library, cave, signatures ? std::addressof(*signatures) : nullptr, report);
+        }
+        for (const auto& site : Patches::GetCallSites(runtime)) {
+            CheckCallSite(a_image, a_library, site, report);
+        }
+
+        std::printf("%zu passed, %zu failed\n", report.passed(), report.failed());
+        if (report.failed() != 0) {
+            return EXIT_FAILURE;
+        }
+
+        if (!a_options.record.empty()) {
+            RecordCaveSignatures(a_image, a_library, runtime, a_options.record);
+            std::printf("recorded the cave signatures to %s\n", a_options.record.string().c_str());
+        }
+        return EXIT_SUCCESS;
+    }
+}  // namespace
+
+int main(int a_argc, char* a_argv[]) {
+    Options options;
+    std::vector<std::string_view> paths;
+    for (int i = 1; i < a_argc; ++i) {
+        const std::string_view arg{a_argv[i]};
+        if (arg == "-v"sv || arg == "--verbose"sv) {
+            options.verbose = true;
+        } else if ((arg == "--signatures"sv || arg == "--record"sv) && i + 1 < a_argc) {
+            (arg == "--record"sv ? options.record : options.signatures) = a_argv[++i];
+        } else {
+            paths.push_back(arg);
+        }
+    }
+
+    if (paths.size() != 2) {
+        std::fprintf(stderr,
+                     "usage: %s [--verbose] [--signatures <file>] [--record <file>] <SkyrimSE.exe> "
+                     "<address library .bin>\n",
+                     a_argv[0]);
+        return 2;
+    }
+
+    try {
+        const PEImage image{std::filesystem::path{paths[0]}};
+        const AddressLibrary library{std::filesystem::path{paths[1]}};
+        return Run(image, library, options);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 2;
+    }
+}
@@ -0,0 +1,113 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+#include "AutoTOML.hpp"
+
+// Times schema::load against a file the size of YesImSure.toml: 24 settings in 6 groups. Parsing the text is toml++'s
+// cost and is timed separately.
+namespace {
+    using namespace std::literals;
+    using namespace AutoTOML::schema;
+    using clock_type = std::chrono::steady_clock;
+
+#define MAKE_SETTING(a_type, a_group, a_key, a_value) \
+    constinit a_type a_key{a_value};                   \
+    constexpr Field a_key##Field { a_group##sv, #a_key##sv, a_key }
+
+    MAKE_SETTING(bSetting, "General", B0, false);
+    MAKE_SETTING(bSetting, "General", B1, false);
+    MAKE_SETTING(bSetting, "Logging", B2, false);
+    MAKE_SETTING(bSetting, "Logging", B3, false);
+    MAKE_SETTING(iSetting, "Logging", I0, 0);
+    MAKE_SETTING(iSetting, "Logging", I1, 0);
+    MAKE_SETTING(iSetting, "Logging", I2, 0);
+    MAKE_SETTING(bSetting, "Patches", B4, false);
+    MAKE_SETTING(bSetting, "Patches", B5, false);
+    MAKE_SETTING(bSetting, "Patches", B6, false);
+    MAKE_SETTING(bSetting, "Patches", B7, false);
+    MAKE_SETTING(bSetting, "Patches", B8, false);
+    MAKE_SETTING(bSetting, "Patches", B9, false);
+    MAKE_SETTING(bSetting, "Patches", B10, false);
+    MAKE_SETTING(bSetting, "Batch", B11, false);
+    MAKE_SETTING(bSetting, "Batch", B12, false);
+    MAKE_SETTING(bSetting, "Batch", B13, false);
+    MAKE_SETTING(bSetting, "Batch", B14, false);
+    MAKE_SETTING(iSetting, "Batch", I3, 0);
+    MAKE_SETTING(bSetting, "Batch", B15, false);
+    MAKE_SETTING(iSetting, "Poison", I4, 0);
+    MAKE_SETTING(bSetting, "Poison", B16, false);
+    MAKE_SETTING(fSetting, "Notifications", F0, 0.0);
+    MAKE_SETTING(fSetting, "Notifications", F1, 0.0);
+
+#undef MAKE_SETTING
+
+    constexpr auto SCHEMA = make_schema(B0Field, B1Field, B2Field, B3Field, I0Field, I1Field, I2Field, B4Field,
+                                        B5Field, B6Field, B7Field, B8Field, B9Field, B10Field, B11Field, B12Field,
+                                        B13Field, B14Field, I3Field, B15Field, I4Field, B16Field, F0Field, F1Field);
+
+    constexpr auto FILE_TEXT = R"(
+        [General]
+        B0 = true
+        B1 = false
+
+        [Logging]
+        B2 = true
+        B3 = false
+        I0 = 2
+        I1 = 8192
+        I2 = 1
+
+        [Patches]
+        B4 = true
+        B5 = true
+        B6 = true
+        B7 = false
+        B8 = false
+        B9 = true
+        B10 = true
+
+        [Batch]
+        B11 = false
+        B12 = false
+        B13 = false
+        B14 = false
+        I3 = 10
+        B15 = false
+
+        [Poison]
+        I4 = 1
+        B16 = false
+
+        [Notifications]
+        F0 = 0.5
+        F1 = 1.0
+
+        [MessageBoxes]
+        sSomePrompt = 0
+    )"sv;
+
+    volatile std::size_t sink = 0;
+
+    template <class F>
+    void Run(std::string_view a_name, std::size_t a_iterations, F a_func) {
+        a_func();
+        const auto start = clock_type::now();
+        for (std::size_t i = 0; i < a_iterations; ++i) {
+            a_func();
+        }
+        const auto elapsed = std::chrono::duration<double, std::nano>(clock_type::now() - start).count();
+        std::printf("%-40.*s %12.1f ns/op\n", static_cast<int>(a_name.size()), a_name.data(),
+                    elapsed / static_cast<double>(a_iterations));
+    }
+}  // namespace
+
+int main() {
+    Run("toml::parse, 24 settings"sv, 10'000, []() { sink = toml::parse(FILE_TEXT).size(); });
+
+    const auto table = toml::parse(FILE_TEXT);
+    Run("schema::load, 24 settings"sv, 100'000, [&]() { sink = load(table, SCHEMA).warnings.size(); });
+    return 0;
+}
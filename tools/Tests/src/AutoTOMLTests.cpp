@@ -0,0 +1,121 @@
+#include <array>
+#include <string>
+#include <string_view>
+
+#include "AutoTOML.hpp"
+#include "Check.h"
+
+namespace {
+    using namespace std::literals;
+    using namespace AutoTOML::schema;
+
+    constinit bSetting Enabled{false};
+    constinit iSetting Quantity{10};
+    constinit fSetting Window{0.5};
+
+    constexpr Field EnabledField{"Patches"sv, "Enabled"sv, Enabled};
+    constexpr Field QuantityField{"Batch"sv, "Quantity"sv, Quantity};
+    constexpr Field WindowField{"Batch"sv, "Window"sv, Window};
+
+    constexpr auto SCHEMA = make_schema(EnabledField, QuantityField, WindowField);
+
+    // sorted by group, then key, for the binary search in stage
+    static_assert(SCHEMA[0].group() == "Batch"sv && SCHEMA[0].key() == "Quantity"sv);
+    static_assert(SCHEMA[1].group() == "Batch"sv && SCHEMA[1].key() == "Window"sv);
+    static_assert(SCHEMA[2].group() == "Patches"sv && SCHEMA[2].key() == "Enabled"sv);
+
+    // the array form Settings.h generates its schema with sorts the same way
+    constexpr auto ARRAY_SCHEMA = make_schema(std::array{EnabledField, QuantityField, WindowField});
+    static_assert(ARRAY_SCHEMA[0].key() == SCHEMA[0].key() && ARRAY_SCHEMA[1].key() == SCHEMA[1].key() &&
+                  ARRAY_SCHEMA[2].key() == SCHEMA[2].key());
+
+    void Reset() {
+        *Enabled = false;
+        *Quantity = 10;
+        *Window = 0.5;
+    }
+
+    void TestLoadsEverything() {
+        Reset();
+        const auto table = toml::parse(R"(
+            [Patches]
+            Enabled = true
+            Unknown = "ignored"
+
+            [Batch]
+            Quantity = 25
+            Window = 1.5
+
+            [Other]
+            Quantity = "not ours"
+        )"sv);
+
+        const auto report = load(table, SCHEMA);
+        CHECK(report.ok());
+        CHECK(report.warnings.empty());
+        CHECK(*Enabled);
+        CHECK(*Quantity == 25);
+        CHECK(*Window == 1.5);
+    }
+
+    void TestMissingIsWarning() {
+        Reset();
+        const auto table = toml::parse(R"(
+            [Batch]
+            Quantity = 3
+        )"sv);
+
+        const auto report = load(table, SCHEMA);
+        CHECK(report.ok());
+        CHECK(report.warnings.find("[Batch] Window"sv) != std::string::npos);
+        CHECK(report.warnings.find("[Patches] Enabled"sv) != std::string::npos);
+        CHECK(*Quantity == 3);
+        CHECK(*Window == 0.5);
+        CHECK(!*Enabled);
+    }
+
+    void TestWrongTypeRejectsFile() {
+        Reset();
+        const auto table = toml::parse(R"(
+            [Patches]
+            Enabled = true
+
+            [Batch]
+            Quantity = "many"
+            Window = 2.0
+        )"sv);
+
+        const auto report = load(table, SCHEMA);
+        CHECK(!report.ok());
+        CHECK(report.errors.find("[Batch] Quantity"sv) != std::string::npos);
+
+        // nothing from a rejected file is applied, not even the valid values
+        CHECK(!*Enabled);
+        CHECK(*Quantity == 10);
+        CHECK(*Window == 0.5);
+    }
+
+    void TestStageThenAssign() {
+        Reset();
+        const auto table = toml::parse(R"(
+            [Patches]
+            Enabled = true
+        )"sv);
+
+        const auto staged = stage(table, SCHEMA);
+        CHECK(staged.report.ok());
+        CHECK(!*Enabled);
+
+        assign(staged, SCHEMA);
+        CHECK(*Enabled);
+        CHECK(*Quantity == 10);
+    }
+}  // namespace
+
+int main() {
+    TestLoadsEverything();
+    TestMissingIsWarning();
+    TestWrongTypeRejectsFile();
+    TestStageThenAssign();
+    return Check::Result("AutoTOMLTests");
+}
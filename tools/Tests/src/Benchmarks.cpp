@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Notifications.h"
+#include "PatchTransaction.h"
+#include "Patches.h"
+#include "Signature.h"
+#include "Thunks.h"
+
+// Micro-benchmarks of the hot paths that run without the game. Prints the mean time per operation of each, take the
+// best of a few runs before comparing two builds.
+namespace {
+    using namespace std::literals;
+    using clock_type = std::chrono::steady_clock;
+
+    // keeps the optimizer from dropping a result
+    volatile std::uintptr_t sink = 0;
+
+    template <class F>
+    void Run(std::string_view a_name, std::size_t a_iterations, F a_func) {
+        a_func();  // warm up
+        const auto start = clock_type::now();
+        for (std::size_t i = 0; i < a_iterations; ++i) {
+            a_func();
+        }
+        const auto elapsed = std::chrono::duration<double, std::nano>(clock_type::now() - start).count();
+        std::printf("%-40.*s %12.1f ns/op\n", static_cast<int>(a_name.size()), a_name.data(),
+                    elapsed / static_cast<double>(a_iterations));
+    }
+
+    // IsDetoured scans the start of every cave, a few dozen bytes
+    void BenchSignature() {
+        constexpr Signature::Pattern ABS_JMP{"FF 25 00 00 00 00"sv};
+
+        std::mt19937 rng{1};
+        std::vector<std::byte> cave(32);
+        for (auto& value : cave) {
+            value = static_cast<std::byte>(rng() & 0xFF);
+        }
+
+        Run("Signature::Find, 32 byte cave"sv, 1'000'000,
+            [&]() { sink = reinterpret_cast<std::uintptr_t>(ABS_JMP.Find(cave)); });
+
+        const Signature::Pattern call{"E8 ?? ?? ?? ??"sv};
+        const auto code = std::vector<std::byte>{std::byte{0xE8}, std::byte{1}, std::byte{2}, std::byte{3},
+                                                 std::byte{4}};
+        Run("Signature::Match, call site"sv, 10'000'000, [&]() { sink = call.Match(code.data()); });
+    }
+
+    // the code generation half of Hooks::QueuePatch: a nop filled image per cave with its thunk copied in
+    void BenchThunks() {
+        const auto& thunk = Patches::GetThunkTemplate(Patches::Thunk::kPoisonCallback);
+        std::uint64_t callAddr = 0x140001000;
+        Run("ThunkTemplate::Instantiate"sv, 10'000'000, [&]() {
+            const auto code = thunk.Instantiate(++callAddr, 0x140002000);
+            sink = static_cast<std::uintptr_t>(code[thunk.size() - 1]);
+        });
+
+        Run("Cave images, every SE cave"sv, 100'000, [&]() {
+            for (const auto& cave : Patches::GetCaves(Patches::Runtime::kSE)) {
+                std::vector<std::byte> image(cave.size(), std::byte{0x90});
+                const auto& caveThunk = Patches::GetThunkTemplate(cave.thunk);
+                const auto code = caveThunk.Instantiate(0x140001000, 0x140002000 + cave.jumpOut);
+                std::copy_n(code.begin(), caveThunk.size(), image.begin());
+                sink = image.size();
+            }
+        });
+    }
+
+    // the table walk of Hooks::QueuePatch for every patch, including parsing each call site's signature, without the
+    // address library lookups
+    void BenchDescriptors() {
+        Run("Patch table walk, every AE patch"sv, 100'000, [&]() {
+            std::size_t found = 0;
+            for (auto patch = std::uint8_t{0}; patch < std::to_underlying(Patches::Patch::kTotal); ++patch) {
+                for (const auto& cave : Patches::GetCaves(Patches::Runtime::kAE)) {
+                    found += std::to_underlying(cave.patch) == patch ? cave.size() : 0;
+                }
+                for (const auto& site : Patches::GetCallSites(Patches::Runtime::kAE)) {
+                    if (std::to_underlying(site.patch) == patch) {
+                        found += Signature::Pattern{site.signature}.size();
+                    }
+                }
+            }
+            sink = found;
+        });
+    }
+
+    void BenchNotifications() {
+        using Notifications::Coalescer;
+        Coalescer coalescer{Coalescer::duration::zero(), Coalescer::duration::zero()};
+        const Coalescer::time_point now{std::chrono::hours{1}};
+
+        Run("Coalescer, 4 pushes and a poll"sv, 1'000'000, [&]() {
+            for (int i = 0; i < 4; ++i) {
+                coalescer.Push("%s learned"sv, "Absorb Health"sv, now);
+            }
+            sink = coalescer.Poll(now).size();
+        });
+    }
+
+    // how long grouping takes for a patch table's worth of edits, the memory itself is not touched
+    class NullBackend : public Patches::IMemoryBackend {
+    public:
+        [[nodiscard]] std::size_t PageSize() const noexcept override { return 4096; }
+
+        [[nodiscard]] bool Unprotect(std::uintptr_t, std::size_t, std::uint32_t& a_oldProtect) noexcept override {
+            a_oldProtect = 0;
+            return false;  // stops Commit before it writes
+        }
+
+        [[nodiscard]] bool Protect(std::uintptr_t, std::size_t, std::uint32_t) noexcept override { return true; }
+
+        void FlushInstructionCache(std::uintptr_t, std::size_t) noexcept override {}
+    };
+
+    void BenchPatchTransaction() {
+        NullBackend backend;
+        std::vector<std::byte> bytes(16, std::byte{0x90});
+
+        Run("PatchTransaction, 32 edits planned"sv, 100'000, [&]() {
+            Patches::PatchTransaction transaction{backend};
+            for (std::uintptr_t i = 0; i < 32; ++i) {
+                transaction.Write(0x140000000 + i * 0x1234, bytes);
+            }
+            sink = transaction.Commit();
+        });
+    }
+}  // namespace
+
+int main() {
+    BenchSignature();
+    BenchThunks();
+    BenchDescriptors();
+    BenchNotifications();
+    BenchPatchTransaction();
+    return 0;
+}
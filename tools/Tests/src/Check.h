@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+// Just enough of a test framework for a handful of executables run by ctest: every failed CHECK prints its location
+// and the test exits non-zero once all checks ran.
+namespace Check {
+    inline int failures = 0;
+
+    inline void Fail(const char* a_expr, const char* a_file, int a_line) {
+        ++failures;
+        std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", a_file, a_line, a_expr);
+    }
+
+    [[nodiscard]] inline int Result(const char* a_name) {
+        if (failures == 0) {
+            std::printf("%s: all checks passed\n", a_name);
+            return EXIT_SUCCESS;
+        }
+        std::fprintf(stderr, "%s: %d checks failed\n", a_name, failures);
+        return EXIT_FAILURE;
+    }
+}  // namespace Check
+
+#define CHECK(a_expr)                                  \
+    do {                                               \
+        if (!(a_expr)) {                               \
+            Check::Fail(#a_expr, __FILE__, __LINE__);  \
+        }                                              \
+    } while (false)
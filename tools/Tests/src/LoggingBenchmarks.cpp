@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <spdlog/async.h>
+#include <spdlog/async_logger.h>
+#include <spdlog/sinks/basic_file_sink.h>
+#include <spdlog/spdlog.h>
+
+// Times a log call on the calling thread for the two file logging modes the plugin has, set up as InitializeLogging
+// does: a synchronous basic_file_sink_mt logger flushed on info, and an async_logger on a one worker thread pool with
+// the default LogQueueSize of 8192. Each mode logs a burst that fits the queue and one that overflows it, which is
+// where the async logger blocks or drops messages depending on BlockOnOverflow. spdlog's queue is a mutex guarded
+// ring buffer, so the async caller can also wait on the worker for the lock.
+namespace {
+    using namespace std::literals;
+    using clock_type = std::chrono::steady_clock;
+
+    constexpr std::size_t QUEUE_SIZE = 8192;
+
+    void Report(std::string_view a_name, std::vector<double>& a_latencies) {
+        std::ranges::sort(a_latencies);
+        double total = 0.0;
+        for (const auto latency : a_latencies) {
+            total += latency;
+        }
+        std::printf("%-48.*s %10.1f ns/op mean %10.1f ns p99 %12.1f ns max\n", static_cast<int>(a_name.size()),
+                    a_name.data(), total / static_cast<double>(a_latencies.size()),
+                    a_latencies[a_latencies.size() * 99 / 100], a_latencies.back());
+    }
+
+    // logs a_count messages back to back and times each call
+    void Run(std::string_view a_name, spdlog::logger& a_log, std::size_t a_count) {
+        std::vector<double> latencies;
+        latencies.reserve(a_count);
+        for (std::size_t i = 0; i < a_count; ++i) {
+            const auto start = clock_type::now();
+            a_log.info("Batch crafted {} items of {}"sv, i, "Iron Dagger"sv);
+            latencies.push_back(std::chrono::duration<double, std::nano>(clock_type::now() - start).count());
+        }
+        Report(a_name, latencies);
+        a_log.flush();
+    }
+
+    void BenchSync(const std::filesystem::path& a_path) {
+        spdlog::logger log{"Sync", std::make_shared<spdlog::sinks::basic_file_sink_mt>(a_path.string(), true)};
+        log.flush_on(spdlog::level::info);
+
+        Run("basic_file_sink_mt, 4096 messages"sv, log, QUEUE_SIZE / 2);
+        Run("basic_file_sink_mt, 65536 messages"sv, log, QUEUE_SIZE * 8);
+    }
+
+    void BenchAsync(const std::filesystem::path& a_path, spdlog::async_overflow_policy a_policy,
+                    std::string_view a_policyName) {
+        auto pool = std::make_shared<spdlog::details::thread_pool>(QUEUE_SIZE, 1);
+        // async_logger hands the worker a shared_from_this, it has to be owned by a shared_ptr
+        const auto log = std::make_shared<spdlog::async_logger>(
+            "Async", std::make_shared<spdlog::sinks::basic_file_sink_mt>(a_path.string(), true), pool, a_policy);
+        log->flush_on(spdlog::level::err);
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "async %.*s, 4096 messages", static_cast<int>(a_policyName.size()),
+                      a_policyName.data());
+        Run(name, *log, QUEUE_SIZE / 2);
+
+        // let the worker drain the first burst so the second one starts from an empty queue
+        std::this_thread::sleep_for(100ms);
+
+        std::snprintf(name, sizeof(name), "async %.*s, 65536 messages", static_cast<int>(a_policyName.size()),
+                      a_policyName.data());
+        Run(name, *log, QUEUE_SIZE * 8);
+    }
+}  // namespace
+
+int main() {
+    const auto path = std::filesystem::temp_directory_path() / "YesImSureLoggingBenchmarks.log";
+
+    BenchSync(path);
+    BenchAsync(path, spdlog::async_overflow_policy::block, "block"sv);
+    BenchAsync(path, spdlog::async_overflow_policy::overrun_oldest, "overrun_oldest"sv);
+
+    std::filesystem::remove(path);
+    return 0;
+}
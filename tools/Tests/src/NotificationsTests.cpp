@@ -0,0 +1,78 @@
+#include <chrono>
+#include <string>
+#include <string_view>
+
+#include "Check.h"
+#include "Notifications.h"
+
+namespace {
+    using namespace std::literals;
+    using Notifications::Coalescer;
+
+    constexpr auto WINDOW = std::chrono::milliseconds{500};
+    constexpr auto INTERVAL = std::chrono::seconds{1};
+    constexpr auto FORMAT = "%s learned"sv;
+
+    const Coalescer::time_point START{std::chrono::hours{1}};
+
+    void TestSingleMessage() {
+        Coalescer coalescer{WINDOW, INTERVAL};
+        CHECK(!coalescer.pending());
+        CHECK(coalescer.Poll(START).empty());
+
+        coalescer.Push(FORMAT, "Fire Damage"sv, START);
+        CHECK(coalescer.pending());
+        CHECK(coalescer.Poll(START + WINDOW / 2).empty());
+
+        const auto msg = coalescer.Poll(START + WINDOW);
+        CHECK(msg == "Fire Damage learned"sv);
+        CHECK(msg.data()[msg.size()] == '\0');
+        CHECK(!coalescer.pending());
+    }
+
+    void TestMergesWithinWindow() {
+        Coalescer coalescer{WINDOW, INTERVAL};
+        coalescer.Push(FORMAT, "Fire Damage"sv, START);
+        coalescer.Push("ignored %s"sv, "Frost Damage"sv, START + WINDOW / 2);
+        CHECK(coalescer.Poll(START + WINDOW) == "Fire Damage, Frost Damage learned"sv);
+    }
+
+    void TestInterval() {
+        Coalescer coalescer{WINDOW, INTERVAL};
+        coalescer.Push(FORMAT, "Fire Damage"sv, START);
+        CHECK(!coalescer.Poll(START + WINDOW).empty());
+
+        // the window alone would be over, the interval since the last message is not
+        coalescer.Push(FORMAT, "Frost Damage"sv, START + WINDOW);
+        CHECK(coalescer.Poll(START + 2 * WINDOW).empty());
+        CHECK(coalescer.Poll(START + WINDOW + INTERVAL) == "Frost Damage learned"sv);
+    }
+
+    void TestSetTiming() {
+        Coalescer coalescer{WINDOW, INTERVAL};
+        coalescer.SetTiming(Coalescer::duration::zero(), Coalescer::duration::zero());
+        coalescer.Push(FORMAT, "Fire Damage"sv, START);
+        CHECK(coalescer.Poll(START) == "Fire Damage learned"sv);
+    }
+
+    void TestTruncation() {
+        Coalescer coalescer{WINDOW, INTERVAL};
+        const std::string name(Coalescer::BUFFER_SIZE, 'x');
+        for (int i = 0; i < 4; ++i) {
+            coalescer.Push(FORMAT, name, START);
+        }
+
+        const auto msg = coalescer.Poll(START + WINDOW);
+        CHECK(msg.size() == Coalescer::BUFFER_SIZE - 1);
+        CHECK(msg.data()[msg.size()] == '\0');
+    }
+}  // namespace
+
+int main() {
+    TestSingleMessage();
+    TestMergesWithinWindow();
+    TestInterval();
+    TestSetTiming();
+    TestTruncation();
+    return Check::Result("NotificationsTests");
+}
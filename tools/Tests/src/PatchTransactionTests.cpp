@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "Check.h"
+#include "PatchTransaction.h"
+
+namespace {
+    // Pretends memory is split into 16 byte pages and records what the transaction asks for. The bytes themselves are
+    // ordinary writable memory.
+    class FakeBackend : public Patches::IMemoryBackend {
+    public:
+        static constexpr std::size_t PAGE_SIZE = 16;
+        static constexpr std::uint32_t READ_EXECUTE = 0x20;
+
+        struct Call {
+            std::uintptr_t address;
+            std::size_t size;
+        };
+
+        [[nodiscard]] std::size_t PageSize() const noexcept override { return PAGE_SIZE; }
+
+        [[nodiscard]] bool Unprotect(std::uintptr_t a_address, std::size_t a_size,
+                                     std::uint32_t& a_oldProtect) noexcept override {
+            if (unprotects.size() == failUnprotectAt) {
+                return false;
+            }
+            unprotects.push_back({a_address, a_size});
+            a_oldProtect = READ_EXECUTE;
+            return true;
+        }
+
+        [[nodiscard]] bool Protect(std::uintptr_t a_address, std::size_t a_size,
+                                   std::uint32_t a_protect) noexcept override {
+            protects.push_back({a_address, a_size});
+            restoredProtect = restoredProtect && a_protect == READ_EXECUTE;
+            return true;
+        }
+
+        void FlushInstructionCache(std::uintptr_t a_address, std::size_t a_size) noexcept override {
+            flushes.push_back({a_address, a_size});
+        }
+
+        std::size_t failUnprotectAt{static_cast<std::size_t>(-1)};
+        std::vector<Call> unprotects;
+        std::vector<Call> protects;
+        std::vector<Call> flushes;
+        bool restoredProtect{true};
+    };
+
+    struct alignas(64) Memory {
+        std::array<std::byte, 256> bytes{};
+
+        [[nodiscard]] std::uintptr_t at(std::size_t a_offset) const noexcept {
+            return reinterpret_cast<std::uintptr_t>(bytes.data() + a_offset);
+        }
+    };
+
+    [[nodiscard]] std::vector<std::byte> Bytes(std::initializer_list<unsigned> a_values) {
+        std::vector<std::byte> bytes;
+        for (const auto value : a_values) {
+            bytes.push_back(static_cast<std::byte>(value));
+        }
+        return bytes;
+    }
+
+    void TestContiguousPagesShareOneRun() {
+        Memory memory;
+        FakeBackend backend;
+        Patches::PatchTransaction transaction{backend};
+
+        // page 0, a write straddling pages 0 and 1, and page 2
+        transaction.Write(memory.at(2), Bytes({0x01}));
+        transaction.Write(memory.at(14), Bytes({0x02, 0x03, 0x04}));
+        transaction.Write(memory.at(40), Bytes({0x05}));
+        CHECK(transaction.Commit());
+
+        CHECK(backend.unprotects.size() == 1);
+        CHECK(backend.unprotects[0].address == memory.at(0));
+        CHECK(backend.unprotects[0].size == 3 * FakeBackend::PAGE_SIZE);
+        CHECK(backend.protects.size() == 1);
+        CHECK(backend.flushes.size() == 1);
+        CHECK(backend.restoredProtect);
+    }
+
+    void TestDistantPagesGetSeparateRuns() {
+        Memory memory;
+        FakeBackend backend;
+        Patches::PatchTransaction transaction{backend};
+
+        // added out of order, the runs come out sorted
+        transaction.Write(memory.at(200), Bytes({0x01}));
+        transaction.Write(memory.at(3), Bytes({0x02}));
+        CHECK(transaction.Commit());
+
+        CHECK(backend.unprotects.size() == 2);
+        CHECK(backend.unprotects[0].address == memory.at(0));
+        CHECK(backend.unprotects[1].address == memory.at(192));
+        CHECK(memory.bytes[200] == std::byte{0x01});
+        CHECK(memory.bytes[3] == std::byte{0x02});
+    }
+
+    void TestFillThenWriteKeepsOrderAndOriginals() {
+        Memory memory;
+        std::fill(memory.bytes.begin(), memory.bytes.end(), std::byte{0xAA});
+
+        FakeBackend backend;
+        Patches::PatchTransaction transaction{backend};
+        transaction.Fill(memory.at(16), 0x90, 8);
+        transaction.Write(memory.at(18), Bytes({0xE8, 0x00}));
+        CHECK(transaction.Commit());
+
+        const auto expected = Bytes({0x90, 0x90, 0xE8, 0x00, 0x90, 0x90, 0x90, 0x90});
+        CHECK(std::equal(expected.begin(), expected.end(), memory.bytes.begin() + 16));
+        CHECK(memory.bytes[15] == std::byte{0xAA});
+        CHECK(memory.bytes[24] == std::byte{0xAA});
+
+        // the fill saw the untouched bytes, the write saw the fill
+        const auto& edits = transaction.edits();
+        CHECK(edits.size() == 2);
+        CHECK(std::ranges::all_of(edits[0].original, [](std::byte a_byte) { return a_byte == std::byte{0xAA}; }));
+        CHECK(edits[1].original == Bytes({0x90, 0x90}));
+    }
+
+    void TestFailedUnprotectWritesNothing() {
+        Memory memory;
+        FakeBackend backend;
+        backend.failUnprotectAt = 1;
+
+        Patches::PatchTransaction transaction{backend};
+        transaction.Write(memory.at(0), Bytes({0x01}));
+        transaction.Write(memory.at(100), Bytes({0x02}));
+        CHECK(!transaction.Commit());
+
+        CHECK(memory.bytes[0] == std::byte{0x00});
+        CHECK(memory.bytes[100] == std::byte{0x00});
+
+        // the run that was unprotected is protected again, nothing is flushed
+        CHECK(backend.unprotects.size() == 1);
+        CHECK(backend.protects.size() == 1);
+        CHECK(backend.flushes.empty());
+    }
+
+    void TestEmptyTransaction() {
+        FakeBackend backend;
+        Patches::PatchTransaction transaction{backend};
+        CHECK(transaction.empty());
+        CHECK(transaction.Commit());
+        CHECK(backend.unprotects.empty());
+    }
+
+    // The protection of the page holding a_address, as listed in /proc/self/maps.
+    [[nodiscard]] std::string GetProtection(std::uintptr_t a_address) {
+        std::ifstream maps{"/proc/self/maps"};
+        std::string line;
+        while (std::getline(maps, line)) {
+            std::uintptr_t begin = 0;
+            std::uintptr_t end = 0;
+            char perms[5]{};
+            if (std::sscanf(line.c_str(), "%lx-%lx %4s", &begin, &end, perms) == 3 && a_address >= begin &&
+                a_address < end) {
+                return perms;
+            }
+        }
+        return {};
+    }
+
+    // the mprotect backend on a real read/execute page
+    void TestNativeBackend() {
+        auto& backend = Patches::GetNativeBackend();
+        const auto pageSize = backend.PageSize();
+        CHECK(pageSize == static_cast<std::size_t>(sysconf(_SC_PAGESIZE)));
+
+        const auto page = mmap(nullptr, pageSize, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        CHECK(page != MAP_FAILED);
+        if (page == MAP_FAILED) {
+            return;
+        }
+
+        const auto address = reinterpret_cast<std::uintptr_t>(page);
+        Patches::PatchTransaction transaction;
+        transaction.Fill(address + 8, 0x90, 4);
+        transaction.Write(address + 9, Bytes({0xC3}));
+        CHECK(transaction.Commit());
+
+        const auto code = static_cast<const std::byte*>(page);
+        CHECK(code[8] == std::byte{0x90});
+        CHECK(code[9] == std::byte{0xC3});
+        CHECK(code[11] == std::byte{0x90});
+        CHECK(GetProtection(address) == "r-xp");
+
+        munmap(page, pageSize);
+    }
+}  // namespace
+
+int main() {
+    TestContiguousPagesShareOneRun();
+    TestDistantPagesGetSeparateRuns();
+    TestFillThenWriteKeepsOrderAndOriginals();
+    TestFailedUnprotectWritesNothing();
+    TestEmptyTransaction();
+    TestNativeBackend();
+    return Check::Result("PatchTransactionTests");
+}
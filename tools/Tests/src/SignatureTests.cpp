@@ -0,0 +1,124 @@
+#include <array>
+#include <cstddef>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Check.h"
+#include "Signature.h"
+
+namespace {
+    using namespace std::literals;
+
+    // parsing is constexpr, the patch table relies on it
+    static_assert(Signature::IsValid("E8 ?? ?? ?? ??"sv));
+    static_assert(Signature::IsValid("48 8b 05"sv));
+    static_assert(!Signature::IsValid(""sv));
+    static_assert(!Signature::IsValid("?? ??"sv));
+    static_assert(!Signature::IsValid("E8 ?"sv));
+    static_assert(!Signature::IsValid("E8?? 00"sv));
+    static_assert(!Signature::IsValid("G0"sv));
+    static_assert(Signature::Pattern{"E8 ?? ?? ?? ??"sv}.size() == 5);
+
+    [[nodiscard]] std::vector<std::byte> Bytes(std::initializer_list<unsigned> a_values) {
+        std::vector<std::byte> bytes;
+        for (const auto value : a_values) {
+            bytes.push_back(static_cast<std::byte>(value));
+        }
+        return bytes;
+    }
+
+    // the obvious definition Find has to agree with
+    [[nodiscard]] const std::byte* FindReference(std::span<const std::byte> a_haystack, std::string_view a_pattern) {
+        std::vector<int> pattern;
+        Signature::detail::Tokenize(a_pattern, [&](std::byte a_byte, bool a_wildcard) {
+            pattern.push_back(a_wildcard ? -1 : static_cast<int>(a_byte));
+        });
+
+        for (std::size_t i = 0; i + pattern.size() <= a_haystack.size(); ++i) {
+            bool match = true;
+            for (std::size_t j = 0; j < pattern.size() && match; ++j) {
+                match = pattern[j] < 0 || static_cast<int>(a_haystack[i + j]) == pattern[j];
+            }
+            if (match) {
+                return a_haystack.data() + i;
+            }
+        }
+        return nullptr;
+    }
+
+    void TestMatch() {
+        const Signature::Pattern pattern{"48 ?? 05"sv};
+        const auto hit = Bytes({0x48, 0x8B, 0x05});
+        const auto miss = Bytes({0x48, 0x8B, 0x06});
+        CHECK(pattern.Match(hit.data()));
+        CHECK(!pattern.Match(miss.data()));
+    }
+
+    void TestFind() {
+        const Signature::Pattern pattern{"E8 ?? ?? ?? ?? 90"sv};
+
+        const auto data = Bytes({0x00, 0xE8, 0x01, 0x02, 0x03, 0x04, 0x91, 0xE8, 0x01, 0x02, 0x03, 0x04, 0x90});
+        CHECK(pattern.Find(data) == data.data() + 7);
+
+        // a match that ends on the last byte
+        CHECK(pattern.Find(std::span{data}.subspan(1)) == data.data() + 7);
+
+        // one byte short of the match
+        CHECK(pattern.Find(std::span{data}.first(data.size() - 1)) == nullptr);
+
+        // shorter than the pattern, and empty
+        CHECK(pattern.Find(std::span{data}.first(3)) == nullptr);
+        CHECK(pattern.Find({}) == nullptr);
+    }
+
+    void TestLeadingWildcards() {
+        const Signature::Pattern pattern{"?? ?? FF 25"sv};
+        const auto data = Bytes({0xFF, 0x25, 0x00, 0xFF, 0x25});
+        CHECK(pattern.Find(data) == data.data() + 1);
+    }
+
+    // random haystacks with planted matches, compared against the reference
+    void TestRandom() {
+        constexpr std::array PATTERNS{"E8 ?? ?? ?? ??"sv, "FF 25 00 00 00 00"sv, "48 ?? ?? 05 ?? C3"sv, "?? 90"sv,
+                                      "00"sv};
+
+        std::mt19937 rng{12345};
+        std::uniform_int_distribution<unsigned> byte{0, 255};
+        std::uniform_int_distribution<std::size_t> size{0, 300};
+
+        for (int round = 0; round < 2000; ++round) {
+            std::vector<std::byte> haystack(size(rng));
+            for (auto& value : haystack) {
+                // a small alphabet so partial and full matches are common
+                value = static_cast<std::byte>(byte(rng) % 4 == 0 ? 0x00 : byte(rng));
+            }
+
+            const auto text = PATTERNS[static_cast<std::size_t>(round) % PATTERNS.size()];
+            const Signature::Pattern pattern{text};
+            if (round % 3 == 0 && haystack.size() >= pattern.size()) {
+                // plant the concrete bytes at a random position
+                const auto at = std::uniform_int_distribution<std::size_t>{0, haystack.size() - pattern.size()}(rng);
+                std::size_t i = 0;
+                Signature::detail::Tokenize(text, [&](std::byte a_byte, bool a_wildcard) {
+                    if (!a_wildcard) {
+                        haystack[at + i] = a_byte;
+                    }
+                    ++i;
+                });
+            }
+
+            CHECK(pattern.Find(haystack) == FindReference(haystack, text));
+        }
+    }
+}  // namespace
+
+int main() {
+    TestMatch();
+    TestFind();
+    TestLeadingWildcards();
+    TestRandom();
+    return Check::Result("SignatureTests");
+}